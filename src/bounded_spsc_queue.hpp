@@ -0,0 +1,152 @@
+#ifndef BOUNDED_SPSC_QUEUE_HPP
+#define BOUNDED_SPSC_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+// ----------------------------------------------------------------------------
+// Lock-free single producer single consumer ring buffer of fixed capacity.
+// The capacity is rounded up to a power of two so that the slot of an index is a mask,
+// the indices are free-running counters on their own cache line, and each side keeps a
+// cached copy of the opposite index to only touch the shared one when it looks full or empty.
+template< typename T >
+    requires std::is_nothrow_move_assignable_v< T > && std::is_default_constructible_v< T >
+class bounded_spsc_queue {
+public:
+    static constexpr size_t DefaultCapacity = 1024;
+
+    // Size of a cache line on the usual targets, std::hardware_destructive_interference_size is not stable across compilers
+    static constexpr size_t cache_line_size = 64;
+
+    bounded_spsc_queue()
+        : bounded_spsc_queue(DefaultCapacity) {}
+
+    explicit bounded_spsc_queue(size_t capacity_)
+        : mask(std::bit_ceil(std::max(capacity_, size_t{ 1 })) - 1)
+        , collection(std::make_unique< T[] >(mask + 1)) {}
+
+    bounded_spsc_queue(const bounded_spsc_queue&) = delete;
+    bounded_spsc_queue& operator=(const bounded_spsc_queue&) = delete;
+
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+    // Producer side, return false if the queue is full
+    template< typename ... Args >
+    [[nodiscard]] bool try_emplace(Args&&... args) {
+        size_t const current_producer_index = producer.index.load(std::memory_order_relaxed);
+        if (current_producer_index - producer.cached_consumer_index == capacity()) {
+            producer.cached_consumer_index = consumer.index.load(std::memory_order_acquire);
+            if (current_producer_index - producer.cached_consumer_index == capacity()) [[unlikely]] {
+                return false;
+            }
+        }
+
+        collection[current_producer_index & mask] = T(std::forward< Args >(args)...);
+        producer.index.store(current_producer_index + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool try_push(T value_) {
+        return try_emplace(std::move(value_));
+    }
+
+    // Push as many values of values_ as there is room for, with a single publication, return the number of values pushed
+    [[nodiscard]] size_t try_push_n(std::span< const T > values_) {
+        size_t const current_producer_index = producer.index.load(std::memory_order_relaxed);
+        size_t free_slots = capacity() - (current_producer_index - producer.cached_consumer_index);
+        if (free_slots < values_.size()) {
+            producer.cached_consumer_index = consumer.index.load(std::memory_order_acquire);
+            free_slots = capacity() - (current_producer_index - producer.cached_consumer_index);
+        }
+
+        size_t const nb_values = std::min(free_slots, values_.size());
+        if (nb_values == 0) {
+            return 0;
+        }
+
+        // The slots may wrap around the end of the buffer
+        size_t const first_slot = current_producer_index & mask;
+        size_t const nb_first_values = std::min(nb_values, capacity() - first_slot);
+        std::copy_n(values_.begin(), nb_first_values, collection.get() + first_slot);
+        std::copy_n(values_.begin() + nb_first_values, nb_values - nb_first_values, collection.get());
+
+        producer.index.store(current_producer_index + nb_values, std::memory_order_release);
+        return nb_values;
+    }
+
+    // Consumer side, return an empty optional if the queue is empty
+    [[nodiscard]] std::optional< T > try_pop() {
+        size_t const current_consumer_index = consumer.index.load(std::memory_order_relaxed);
+        if (current_consumer_index == consumer.cached_producer_index) {
+            consumer.cached_producer_index = producer.index.load(std::memory_order_acquire);
+            if (current_consumer_index == consumer.cached_producer_index) [[unlikely]] {
+                return {};
+            }
+        }
+
+        std::optional< T > data(std::move(collection[current_consumer_index & mask]));
+        consumer.index.store(current_consumer_index + 1, std::memory_order_release);
+        return data;
+    }
+
+    // Pop up to values_.size() values with a single publication, return the number of values popped
+    [[nodiscard]] size_t try_pop_n(std::span< T > values_) {
+        size_t const current_consumer_index = consumer.index.load(std::memory_order_relaxed);
+        size_t available = consumer.cached_producer_index - current_consumer_index;
+        if (available < values_.size()) {
+            consumer.cached_producer_index = producer.index.load(std::memory_order_acquire);
+            available = consumer.cached_producer_index - current_consumer_index;
+        }
+
+        size_t const nb_values = std::min(available, values_.size());
+        if (nb_values == 0) {
+            return 0;
+        }
+
+        size_t const first_slot = current_consumer_index & mask;
+        size_t const nb_first_values = std::min(nb_values, capacity() - first_slot);
+        std::move(collection.get() + first_slot, collection.get() + first_slot + nb_first_values, values_.begin());
+        std::move(collection.get(), collection.get() + (nb_values - nb_first_values), values_.begin() + nb_first_values);
+
+        consumer.index.store(current_consumer_index + nb_values, std::memory_order_release);
+        return nb_values;
+    }
+
+    // Only a snapshot when the other side is running
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        size_t const current_consumer_index = consumer.index.load(std::memory_order_acquire);
+        size_t const current_producer_index = producer.index.load(std::memory_order_acquire);
+        return current_producer_index - current_consumer_index;
+    }
+
+private:
+    // Index owned by one side and the last value of the opposite index it has seen
+    struct alignas(cache_line_size) producer_state {
+        std::atomic_size_t index{ 0 };
+        size_t cached_consumer_index{ 0 };
+    };
+
+    struct alignas(cache_line_size) consumer_state {
+        std::atomic_size_t index{ 0 };
+        size_t cached_producer_index{ 0 };
+    };
+
+    // Read only after construction, shared by both sides
+    alignas(cache_line_size) size_t mask;
+    std::unique_ptr< T[] > collection;
+
+    producer_state producer;
+    consumer_state consumer;
+};
+
+#endif
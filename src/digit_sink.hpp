@@ -0,0 +1,228 @@
+#ifndef DIGIT_SINK_HPP
+#define DIGIT_SINK_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Block of consecutive digits, its ownership is moved from the producer to the sink
+using digit_chunk = std::string;
+
+// Destination of the streamed digits, write is called with every chunk available at once
+// and flush when the digits written so far should become visible
+template< typename T >
+concept digit_sink = requires(T sink_, std::span< const digit_chunk > chunks_) {
+    sink_.write(chunks_);
+    sink_.flush();
+};
+
+// ----------------------------------------------------------------------------
+// Sink writing to a std::ostream
+class ostream_digit_sink {
+public:
+    explicit ostream_digit_sink(std::ostream& stream_)
+        : stream(stream_) {}
+
+    void write(std::span< const digit_chunk > chunks_) {
+        for (const auto& chunk : chunks_) {
+            stream.write(chunk.data(), static_cast< std::streamsize >(chunk.size()));
+        }
+    }
+
+    void flush() {
+        stream.flush();
+    }
+
+private:
+    std::ostream& stream;
+};
+
+#if defined(__unix__)
+
+// ----------------------------------------------------------------------------
+// Sink writing to a file descriptor, all the chunks available are written with a single writev
+class file_descriptor_digit_sink {
+public:
+    explicit file_descriptor_digit_sink(int file_descriptor_)
+        : file_descriptor(file_descriptor_) {}
+
+    void write(std::span< const digit_chunk > chunks_) {
+        buffers.clear();
+        for (const auto& chunk : chunks_) {
+            if (!chunk.empty()) {
+                buffers.push_back({ const_cast< char* >(chunk.data()), chunk.size() });
+            }
+        }
+
+        // A partial write leaves the remaining bytes in the buffers
+        std::span< iovec > pending(buffers);
+        while (!pending.empty()) {
+            const ssize_t nb_written = ::writev(file_descriptor, pending.data(), static_cast< int >(std::min< size_t >(pending.size(), max_nb_buffers)));
+            if (nb_written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "writev");
+            }
+
+            size_t remaining = static_cast< size_t >(nb_written);
+            while (!pending.empty() && remaining >= pending.front().iov_len) {
+                remaining -= pending.front().iov_len;
+                pending = pending.subspan(1);
+            }
+            if (remaining > 0) {
+                pending.front().iov_base = static_cast< char* >(pending.front().iov_base) + remaining;
+                pending.front().iov_len -= remaining;
+            }
+        }
+    }
+
+    // Nothing is buffered in user space
+    void flush() {}
+
+private:
+#if defined(IOV_MAX)
+    static constexpr size_t max_nb_buffers = IOV_MAX;
+#else
+    static constexpr size_t max_nb_buffers = 16; // Lowest value allowed by POSIX
+#endif
+
+    int file_descriptor;
+    std::vector< iovec > buffers;
+};
+
+// ----------------------------------------------------------------------------
+// Sink writing straight into a memory-mapped file, for very long runs on disk.
+// The file grows by extents of extent_size bytes, only the current extent is mapped,
+// and the file is trimmed to the digits written when the sink is destroyed.
+class mapped_file_digit_sink {
+public:
+    struct options {
+        size_t extent_size = size_t{ 64 } << 20;   // Rounded up to a multiple of the page size
+        size_t sync_interval = 0;                  // Bytes between two synchronizations to disk, 0 to never sync
+    };
+
+    explicit mapped_file_digit_sink(const std::filesystem::path& path_)
+        : mapped_file_digit_sink(path_, options{}) {}
+
+    mapped_file_digit_sink(const std::filesystem::path& path_, options options_)
+        : extent_size(round_to_pages(std::max(options_.extent_size, size_t{ 1 })))
+        , sync_interval(options_.sync_interval) {
+        file_descriptor = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (file_descriptor < 0) {
+            throw std::system_error(errno, std::generic_category(), "open");
+        }
+    }
+
+    mapped_file_digit_sink(const mapped_file_digit_sink&) = delete;
+    mapped_file_digit_sink& operator=(const mapped_file_digit_sink&) = delete;
+
+    ~mapped_file_digit_sink() {
+        unmap();
+        std::ignore = ::ftruncate(file_descriptor, static_cast< off_t >(size));
+        ::close(file_descriptor);
+    }
+
+    void write(std::span< const digit_chunk > chunks_) {
+        for (const auto& chunk : chunks_) {
+            std::span< const char > pending(chunk);
+            while (!pending.empty()) {
+                if (extent_position == extent_size || extent == nullptr) {
+                    map_next_extent();
+                }
+
+                const size_t nb_bytes = std::min(pending.size(), extent_size - extent_position);
+                std::memcpy(extent + extent_position, pending.data(), nb_bytes);
+                extent_position += nb_bytes;
+                size += nb_bytes;
+                pending = pending.subspan(nb_bytes);
+            }
+        }
+
+        if (sync_interval != 0 && size - synchronized_size >= sync_interval) {
+            sync();
+        }
+    }
+
+    // The mapped pages are already visible to the readers of the file
+    void flush() {}
+
+    // Write the digits to disk, including the extents that are no longer mapped
+    void sync() {
+        if (extent != nullptr && ::msync(extent, extent_size, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+        if (::fsync(file_descriptor) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fsync");
+        }
+        synchronized_size = size;
+    }
+
+    [[nodiscard]] size_t get_size() const { return size; }
+
+private:
+    [[nodiscard]] static size_t round_to_pages(size_t bytes_) {
+        const auto page_size = static_cast< size_t >(::sysconf(_SC_PAGESIZE));
+        return (bytes_ + page_size - 1) / page_size * page_size;
+    }
+
+    // Grow the file by one extent and map it in place of the current one, which is full.
+    // The extent is allocated on disk first: writing to a sparse mapping of a full disk raises SIGBUS.
+    void map_next_extent() {
+        unmap();
+
+        const size_t extent_offset = size;
+        const int error = ::posix_fallocate(file_descriptor, static_cast< off_t >(extent_offset), static_cast< off_t >(extent_size));
+        if (error != 0) {
+            throw std::system_error(error, std::generic_category(), "posix_fallocate");
+        }
+
+        void* address = ::mmap(nullptr, extent_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, static_cast< off_t >(extent_offset));
+        if (address == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+
+        extent = static_cast< char* >(address);
+        extent_position = 0;
+    }
+
+    // The dirty pages are written back by the kernel after munmap
+    void unmap() {
+        if (extent != nullptr) {
+            ::munmap(extent, extent_size);
+            extent = nullptr;
+        }
+    }
+
+    size_t extent_size;
+    size_t sync_interval;
+
+    int file_descriptor = -1;
+    char* extent = nullptr;
+    size_t extent_position = 0;
+    size_t size = 0;
+    size_t synchronized_size = 0;
+};
+
+#endif
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
 #include <coroutine>
 #include <exception>
 #include <utility>
@@ -61,4 +64,6 @@ public:
 
         T current_value{};
     };
-};
\ No newline at end of file
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HUGE_PAGE_RESOURCE_HPP
+#define HUGE_PAGE_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Memory resource for multi-megabyte operands: the large blocks are aligned on
+// huge pages (and backed by transparent huge pages on Linux) to reduce the TLB
+// misses of the linear passes, the small ones are forwarded to upstream
+class huge_page_resource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t huge_page_size = size_t{ 2 } << 20;
+
+    explicit huge_page_resource(size_t threshold_ = huge_page_size, std::pmr::memory_resource* upstream_ = std::pmr::get_default_resource())
+        : threshold(threshold_)
+        , upstream(upstream_) {}
+
+    [[nodiscard]] size_t get_threshold() const { return threshold; }
+    [[nodiscard]] std::pmr::memory_resource* get_upstream() const { return upstream; }
+
+private:
+    [[nodiscard]] static size_t round_to_huge_pages(size_t bytes_) {
+        return (bytes_ + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    void* do_allocate(size_t bytes_, size_t alignment_) override {
+        if (bytes_ < threshold || alignment_ > huge_page_size) {
+            return upstream->allocate(bytes_, alignment_);
+        }
+
+        void* pointer = ::operator new(round_to_huge_pages(bytes_), std::align_val_t{ huge_page_size });
+#if defined(__linux__)
+        // Only a hint, the kernel may still use regular pages
+        madvise(pointer, round_to_huge_pages(bytes_), MADV_HUGEPAGE);
+#endif
+        return pointer;
+    }
+
+    void do_deallocate(void* pointer_, size_t bytes_, size_t alignment_) override {
+        if (bytes_ < threshold || alignment_ > huge_page_size) {
+            upstream->deallocate(pointer_, bytes_, alignment_);
+            return;
+        }
+
+        ::operator delete(pointer_, round_to_huge_pages(bytes_), std::align_val_t{ huge_page_size });
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other_) const noexcept override {
+        return this == &other_;
+    }
+
+    size_t threshold;
+    std::pmr::memory_resource* upstream;
+};
+
+#endif
@@ -1,10 +1,33 @@
 #include "large_unsigned_integer.hpp"
 
+#include "large_unsigned_integer_kernels.hpp"
+
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
 #include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+
+namespace details {
 
-#include "utility.hpp"
+[[nodiscard]] large_unsigned_integer compute_reciprocal(const large_unsigned_integer& divisor_);
+
+}
 
 namespace {
 
@@ -16,6 +39,11 @@ using signed_extended_type = large_unsigned_integer::signed_extended_type;
 constexpr const auto nb_extended_type_bits = large_unsigned_integer::nb_extended_type_bits;
 constexpr const auto base = large_unsigned_integer::base;
 
+using details::kernels::add_with_carry;
+using details::kernels::subtract_with_borrow;
+using details::kernels::multiply_add;
+using details::kernels::get_kernels;
+
 // ------------------------------------------------------------------------
 // Helper function that compare 2 large unsigned intergers
 [[nodiscard]] std::strong_ordering compare_large_unsigned_integer(const collection_type& lhs_, const collection_type& rhs_) {
@@ -25,26 +53,7 @@ constexpr const auto base = large_unsigned_integer::base;
             : std::strong_ordering::greater;
     }
 
-#if defined(__cpp_lib_ranges_zip) && __cpp_lib_ranges_zip >= 202110L
-    for (const auto& [lhs, rhs] :
-        std::views::zip(lhs_, rhs_) | std::views::reverse) {
-        if (lhs != rhs) {
-            return (lhs < rhs)
-                ? std::strong_ordering::less
-                : std::strong_ordering::greater;
-        }
-    }
-#else
-    auto [it_lhs, it_rhs] = std::ranges::mismatch(lhs_ | std::views::reverse,
-        rhs_ | std::views::reverse);
-    if (it_lhs != lhs_.rend()) {
-        return (*it_lhs < *it_rhs)
-            ? std::strong_ordering::less
-            : std::strong_ordering::greater;
-    }
-#endif
-
-    return std::strong_ordering::equal;
+    return get_kernels().compare(lhs_.data(), rhs_.data(), lhs_.size());
 }
 
 // ------------------------------------------------------------------------
@@ -54,414 +63,1669 @@ constexpr const auto base = large_unsigned_integer::base;
     return result == std::strong_ordering::equal || result == std::strong_ordering::greater;
 }
 
+std::atomic<large_unsigned_integer::storage_policy> current_storage_policy{ large_unsigned_integer::storage_policy::keep_capacity };
+
 // ------------------------------------------------------------------------
 // Helper function that trims the usless upper zeros
-[[nodiscard]] collection_type trim_upper_zeros(collection_type&& data_) {
+void trim_upper_zeros(collection_type& data_) {
     auto it = std::ranges::find_if(data_ | std::views::reverse, [](auto value_) { return value_ != 0; });
     data_.erase(it.base(), data_.end());
-    return data_;
 }
 
 // ------------------------------------------------------------------------
-// cleanup data to reduce the memory footprint and useless computation
-[[nodiscard]] collection_type cleanup(collection_type&& data_) {
+// cleanup data in place to reduce the memory footprint and useless computation
+void cleanup_in_place(collection_type& data_) {
     // Remove useless zeros
-    data_ = trim_upper_zeros(std::move(data_));
+    trim_upper_zeros(data_);
 
-    // Free unused data
-    data_.shrink_to_fit();
+    // Free unused data only when requested as it usually reallocates
+    if (current_storage_policy.load(std::memory_order_relaxed) == large_unsigned_integer::storage_policy::shrink_to_fit) {
+        data_.shrink_to_fit();
+    }
+}
 
+// ------------------------------------------------------------------------
+// cleanup data to reduce the memory footprint and useless computation
+[[nodiscard]] collection_type cleanup(collection_type&& data_) {
+    cleanup_in_place(data_);
     return data_;
 }
 
 // ------------------------------------------------------------------------
-// Helper function that add 2 sorted large unsigned intergers
-[[nodiscard]] collection_type add_large_unsigned_integer_sorted(const collection_type& lhs_, const collection_type& rhs_) {
-    assert(sorted(lhs_, rhs_));
+// Parallel execution
+//
+// The threads are only started for operands above the thresholds of the parallel
+// policy. The extra threads come from a budget shared by the nested calls so that
+// the recursive multiplications never run more than nb_threads threads at once
+
+std::atomic_size_t parallel_nb_threads{ large_unsigned_integer::parallel_policy{}.nb_threads };
+std::atomic_size_t parallel_multiplication_threshold{ large_unsigned_integer::parallel_policy{}.multiplication_threshold };
+std::atomic_size_t parallel_linear_threshold{ large_unsigned_integer::parallel_policy{}.linear_threshold };
+std::atomic_size_t nb_available_threads{ large_unsigned_integer::parallel_policy{}.nb_threads - 1 };
+
+[[nodiscard]] bool is_parallel(size_t size_, const std::atomic_size_t& threshold_) {
+    return size_ >= threshold_.load(std::memory_order_relaxed) && nb_available_threads.load(std::memory_order_relaxed) > 0;
+}
+
+// ------------------------------------------------------------------------
+// Run task_(0), ..., task_(nb_tasks_ - 1) on the calling thread and on the threads
+// left in the budget, the first exception thrown by a task is rethrown
+void parallel_for(size_t nb_tasks_, const std::function<void(size_t)>& task_) {
+    size_t nb_threads = nb_available_threads.load(std::memory_order_relaxed);
+    size_t nb_workers = 0;
+    do {
+        nb_workers = std::min(nb_threads, nb_tasks_ - 1);
+    } while (nb_workers > 0 && !nb_available_threads.compare_exchange_weak(nb_threads, nb_threads - nb_workers, std::memory_order_relaxed));
+
+    std::atomic_size_t next_task{ 0 };
+    std::mutex mutex;
+    std::exception_ptr exception;
+    const auto work = [&] {
+        for (size_t index = next_task++; index < nb_tasks_; index = next_task++) {
+            try {
+                task_(index);
+            } catch (...) {
+                std::scoped_lock lock(mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(nb_workers);
+        for (size_t index = 0; index < nb_workers; ++index) {
+            workers.emplace_back(work);
+        }
+        work();
+    }
 
-    std::vector<underlying_type> result_data(lhs_.size() + 1, 0);
+    nb_available_threads.fetch_add(nb_workers, std::memory_order_relaxed);
 
-    size_t index = 0;
-    for (; index < rhs_.size(); ++index) {
-        const extended_type lhs_value = lhs_[index];
-        const extended_type rhs_value = rhs_[index];
-        const extended_type old_result = result_data[index];
-        const extended_type sum = lhs_value + rhs_value + old_result;
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
 
-        // Keep only the lower part that can be stored in underlying_type
-        result_data[index] = static_cast<underlying_type>(sum);
+// ------------------------------------------------------------------------
+// Carry propagating add and subtract on raw limbs. On huge operands, the blocks
+// are computed in parallel without incoming carry, then each carry is propagated
+// into the next block where it stops at the first limb that does not overflow
+
+template<typename kernel_type, typename primitive_type>
+[[nodiscard]] bool propagate_by_blocks(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool carry_, kernel_type kernel_, primitive_type primitive_) {
+    const size_t nb_blocks = parallel_nb_threads.load(std::memory_order_relaxed);
+    const size_t block_size = (size_ + nb_blocks - 1) / nb_blocks;
+
+    std::vector<char> carries(nb_blocks, 0);
+    parallel_for(nb_blocks, [&](size_t block_) {
+        const size_t begin = std::min(block_ * block_size, size_);
+        const size_t end = std::min(begin + block_size, size_);
+        carries[block_] = kernel_(result_ + begin, lhs_ + begin, rhs_ + begin, end - begin, block_ == 0 && carry_);
+    });
 
-        // Compute the overflow that cannot be stored
-        result_data[index + 1] = sum >> nb_extended_type_bits;
+    // A block that overflows cannot also let an incoming carry through
+    bool carry = carries[0] != 0;
+    for (size_t block = 1; block < nb_blocks; ++block) {
+        for (size_t index = block * block_size; carry && index < std::min((block + 1) * block_size, size_); ++index) {
+            result_[index] = primitive_(result_[index], 0, carry);
+        }
+        carry = carry || carries[block] != 0;
     }
 
-    // Expand the overflow
-    for (; index < lhs_.size(); ++index) {
-        const extended_type lhs_value = lhs_[index];
-        const extended_type old_result = result_data[index];
-        const extended_type sum = lhs_value + old_result;
+    return carry;
+}
+
+[[nodiscard]] bool add_limbs(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool carry_) {
+    if (!is_parallel(size_, parallel_linear_threshold)) {
+        return get_kernels().add(result_, lhs_, rhs_, size_, carry_);
+    }
 
-        // Keep only the lower part that can be stored in underlying_type
-        result_data[index] = static_cast<underlying_type>(sum);
+    return propagate_by_blocks(result_, lhs_, rhs_, size_, carry_, get_kernels().add, add_with_carry);
+}
 
-        // Compute the overflow that cannot be stored
-        result_data[index + 1] = sum >> nb_extended_type_bits;
+[[nodiscard]] bool subtract_limbs(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool borrow_) {
+    if (!is_parallel(size_, parallel_linear_threshold)) {
+        return get_kernels().subtract(result_, lhs_, rhs_, size_, borrow_);
     }
 
-    return cleanup(std::move(result_data));
+    return propagate_by_blocks(result_, lhs_, rhs_, size_, borrow_, get_kernels().subtract, subtract_with_borrow);
 }
 
 // ------------------------------------------------------------------------
+// Helper function that add 2 sorted large unsigned intergers
+[[nodiscard]] collection_type add_large_unsigned_integer_sorted(const collection_type& lhs_, const collection_type& rhs_) {
+    assert(sorted(lhs_, rhs_));
 
-std::tuple<signed_extended_type, bool> subtract_one_digit(signed_extended_type lhs_value_, signed_extended_type rhs_value_, bool carry_) {
-    if (carry_) {
-        --lhs_value_;
-    }
+    collection_type result_data(lhs_.size() + 1, 0);
 
-    if (lhs_value_ < rhs_value_) {
-        lhs_value_ += base;
-        carry_ = true;
-    } else {
-        carry_ = false;
+    bool carry = add_limbs(result_data.data(), lhs_.data(), rhs_.data(), rhs_.size(), false);
+    size_t index = rhs_.size();
+
+    // Expand the overflow
+    for (; index < lhs_.size(); ++index) {
+        result_data[index] = add_with_carry(lhs_[index], 0, carry);
     }
 
-    return { lhs_value_ - rhs_value_, carry_ };
-};
+    result_data[index] = carry;
+
+    return cleanup(std::move(result_data));
+}
 
 // ------------------------------------------------------------------------
 // Helper function that subtract 2 sorted large unsigned intergers
 [[nodiscard]] collection_type subtract_large_unsigned_integer_sorted(const collection_type& lhs_, const collection_type& rhs_) {
     assert(sorted(lhs_, rhs_));
 
-    std::vector<underlying_type> result_data;
-    result_data.reserve(lhs_.size());
+    collection_type result_data(lhs_.size(), 0);
 
     // Subtract every digit of rhs from the corresponding lhs
-    bool carry = false;
-    const size_t min_size = rhs_.size();
-    size_t index = 0;
-    std::generate_n(std::back_inserter(result_data), min_size, [&carry, &index, &lhs_, &rhs_] {
-        const signed_extended_type lhs_value = lhs_[index];
-        const signed_extended_type rhs_value = rhs_[index];
-        ++index;
-
-        const auto [difference, new_carry] = subtract_one_digit(lhs_value, rhs_value, carry);
-        carry = new_carry;
-
-        assert(difference >= 0);
-        assert(difference <= std::numeric_limits<underlying_type>::max());
-        return static_cast<underlying_type>(difference);
-    });
+    bool borrow = subtract_limbs(result_data.data(), lhs_.data(), rhs_.data(), rhs_.size(), false);
+    size_t index = rhs_.size();
 
-    // Extend the carry to the rest of lhs
+    // Extend the borrow to the rest of lhs
     for (; index < lhs_.size(); ++index) {
-        const signed_extended_type lhs_value = lhs_[index];
-        const signed_extended_type rhs_value = 0;
+        result_data[index] = subtract_with_borrow(lhs_[index], 0, borrow);
+    }
+
+    assert(!borrow);
+
+    return cleanup(std::move(result_data));
+}
 
-        const auto [difference, new_carry] = subtract_one_digit(lhs_value, rhs_value, carry);
-        carry = new_carry;
+// ------------------------------------------------------------------------
+// Helper function that add rhs into lhs, lhs is resized as needed
+void add_large_unsigned_integer_in_place(collection_type& lhs_, const collection_type& rhs_) {
+    if (lhs_.size() < rhs_.size()) {
+        lhs_.resize(rhs_.size(), 0);
+    }
+
+    bool carry = add_limbs(lhs_.data(), lhs_.data(), rhs_.data(), rhs_.size(), false);
+    size_t index = rhs_.size();
 
-        assert(difference >= 0);
-        assert(difference <= std::numeric_limits<underlying_type>::max());
-        result_data.emplace_back(static_cast<underlying_type>(difference));
+    // Propagate the carry only as far as needed
+    for (; carry && index < lhs_.size(); ++index) {
+        lhs_[index] = add_with_carry(lhs_[index], 0, carry);
     }
 
-    return cleanup(std::move(result_data));
+    if (carry) {
+        lhs_.emplace_back(1);
+    }
 }
 
 // ------------------------------------------------------------------------
-// Helper function that multiply 2 sorted large unsigned intergers
-[[nodiscard]] collection_type multiply_large_unsigned_integer_sorted(const collection_type& lhs_, const collection_type& rhs_) {
+// Helper function that add a single value into lhs, only the carry is propagated
+void add_large_unsigned_integer_in_place(collection_type& lhs_, underlying_type value_) {
+    if (lhs_.empty()) {
+        if (value_ != 0) {
+            lhs_.emplace_back(value_);
+        }
+        return;
+    }
+
+    bool carry = false;
+    lhs_[0] = add_with_carry(lhs_[0], value_, carry);
+    for (size_t index = 1; carry && index < lhs_.size(); ++index) {
+        lhs_[index] = add_with_carry(lhs_[index], 0, carry);
+    }
+
+    if (carry) {
+        lhs_.emplace_back(1);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Helper function that subtract rhs from lhs in place (lhs_ >= rhs_)
+void subtract_large_unsigned_integer_in_place(collection_type& lhs_, const collection_type& rhs_) {
     assert(sorted(lhs_, rhs_));
 
-    collection_type result_data(lhs_.size() * rhs_.size() + 1, 0);
+    bool borrow = subtract_limbs(lhs_.data(), lhs_.data(), rhs_.data(), rhs_.size(), false);
+    size_t index = rhs_.size();
 
-    // Multiply each digit of rhs with each digit of lhs
-    size_t result_index = 0;
-    for (size_t rhs_index = 0; rhs_index < rhs_.size(); ++rhs_index) {
-        extended_type overflow{ 0 };
-        result_index = rhs_index;
-        for (const extended_type lhs_value : lhs_) {
-            const extended_type rhs_value = rhs_[rhs_index];
-            const extended_type old_result = result_data[result_index];
+    // Propagate the borrow only as far as needed
+    for (; borrow && index < lhs_.size(); ++index) {
+        lhs_[index] = subtract_with_borrow(lhs_[index], 0, borrow);
+    }
 
-            const extended_type value = lhs_value * rhs_value + overflow + old_result;
-            result_data[result_index] = static_cast<underlying_type>(value);
+    assert(!borrow);
 
-            overflow = value >> nb_extended_type_bits;
+    cleanup_in_place(lhs_);
+}
 
-            ++result_index;
-        }
+// ------------------------------------------------------------------------
+// Helper function that compute lhs * factor + value in place
+void multiply_add_large_unsigned_integer_in_place(collection_type& lhs_, underlying_type factor_, underlying_type value_) {
+    const underlying_type overflow = get_kernels().multiply_add(lhs_.data(), lhs_.data(), lhs_.size(), factor_, value_);
 
-        result_data[result_index] = static_cast<underlying_type>(overflow);
+    if (overflow != 0) {
+        lhs_.emplace_back(overflow);
     }
 
-    return cleanup(std::move(result_data));
+    // Only a null factor can introduce upper zeros
+    if (factor_ == 0) {
+        cleanup_in_place(lhs_);
+    }
 }
 
-} // Anonymous namespace
+// ------------------------------------------------------------------------
+// Multiplication kernels
+//
+// The kernels work on spans of limbs and overwrite result_[0, lhs_.size() + rhs_.size())
+// They are selected by size, from the fastest on small operands to the fastest on huge ones:
+// schoolbook -> Karatsuba -> Toom-Cook 3 -> number-theoretic transform (NTT)
+// Squaring is detected when both operands are the same span and uses dedicated kernels
 
-// ----------------------------------------------------------------------------
+using limbs_view = std::span<const underlying_type>;
+using limbs_span = std::span<underlying_type>;
 
-large_unsigned_integer::large_unsigned_integer() : large_unsigned_integer(0u) {}
+std::atomic_size_t karatsuba_threshold{ large_unsigned_integer::multiplication_thresholds{}.karatsuba };
+std::atomic_size_t toom_3_threshold{ large_unsigned_integer::multiplication_thresholds{}.toom_3 };
+std::atomic_size_t ntt_threshold{ large_unsigned_integer::multiplication_thresholds{}.ntt };
 
-// ----------------------------------------------------------------------------
+void multiply(limbs_span result_, limbs_view lhs_, limbs_view rhs_);
 
-large_unsigned_integer::large_unsigned_integer(std::vector<underlying_type> data_)
-    : data(cleanup(std::move(data_))) {}
+// ------------------------------------------------------------------------
 
-// ----------------------------------------------------------------------------
+[[nodiscard]] bool is_square(limbs_view lhs_, limbs_view rhs_) {
+    return lhs_.data() == rhs_.data() && lhs_.size() == rhs_.size();
+}
 
-[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator+(const large_unsigned_integer& other_) const {
-    // Enforce lhs to be larger than rhs
-    if (*this < other_) {
-        return other_ + (*this);
-    }
+// ------------------------------------------------------------------------
 
-    return add_large_unsigned_integer_sorted(data, other_.data);
+[[nodiscard]] limbs_view trimmed(limbs_view data_) {
+    while (!data_.empty() && data_.back() == 0) {
+        data_ = data_.first(data_.size() - 1);
+    }
+    return data_;
 }
 
-// ----------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+// result_ += value_, return the carry that does not fit in result_
+[[nodiscard]] bool add_in_place(limbs_span result_, limbs_view value_) {
+    assert(result_.size() >= value_.size());
 
-[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator-(const large_unsigned_integer& other_) const {
-    assert(*this >= other_);    // Enforce a positive result
+    bool carry = add_limbs(result_.data(), result_.data(), value_.data(), value_.size(), false);
+    size_t index = value_.size();
 
-    if (*this < other_) {
-        return {};
+    for (; carry && index < result_.size(); ++index) {
+        result_[index] = add_with_carry(result_[index], 0, carry);
     }
 
-    return subtract_large_unsigned_integer_sorted(data, other_.data);
+    return carry;
 }
 
-// ----------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+// result_ -= value_, return the borrow that does not fit in result_
+[[nodiscard]] bool subtract_in_place(limbs_span result_, limbs_view value_) {
+    assert(result_.size() >= value_.size());
 
-[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator*(const large_unsigned_integer& other_) const {
-    // Enforce lhs to be larger than rhs
-    if (*this < other_) {
-        return other_ * (*this);
+    bool borrow = subtract_limbs(result_.data(), result_.data(), value_.data(), value_.size(), false);
+    size_t index = value_.size();
+
+    for (; borrow && index < result_.size(); ++index) {
+        result_[index] = subtract_with_borrow(result_[index], 0, borrow);
     }
 
-    return multiply_large_unsigned_integer_sorted(data, other_.data);
+    return borrow;
 }
 
-// ----------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+// Sum of 2 spans as a new collection with one extra limb for the carry
+[[nodiscard]] collection_type add(limbs_view lhs_, limbs_view rhs_) {
+    if (lhs_.size() < rhs_.size()) {
+        std::swap(lhs_, rhs_);
+    }
 
-[[nodiscard]] std::strong_ordering large_unsigned_integer::operator<=>(const large_unsigned_integer& other_) const {
-    return compare_large_unsigned_integer(data, other_.data);
+    collection_type result(lhs_.size() + 1, 0);
+    std::ranges::copy(lhs_, result.begin());
+    std::ignore = add_in_place(result, rhs_);
+    return result;
 }
 
 // ------------------------------------------------------------------------
 
-[[nodiscard]] bool large_unsigned_integer::operator==(const large_unsigned_integer& other_) const {
-    return this->data == other_.data;
+void multiply_schoolbook(limbs_span result_, limbs_view lhs_, limbs_view rhs_) {
+    std::ranges::fill(result_.first(lhs_.size() + rhs_.size()), 0);
+
+    // Multiply each digit of rhs with each digit of lhs
+    for (size_t rhs_index = 0; rhs_index < rhs_.size(); ++rhs_index) {
+        const underlying_type rhs_value = rhs_[rhs_index];
+        if (rhs_value == 0) {
+            continue;
+        }
+
+        underlying_type overflow = 0;
+        size_t result_index = rhs_index;
+        for (const auto lhs_value : lhs_) {
+            result_[result_index] = multiply_add(lhs_value, rhs_value, result_[result_index], overflow);
+            ++result_index;
+        }
+
+        result_[result_index] = overflow;
+    }
 }
 
 // ------------------------------------------------------------------------
+// Compute every cross product once, double them and add the squares of the diagonal
+void square_schoolbook(limbs_span result_, limbs_view value_) {
+    const size_t size = value_.size();
+    std::ranges::fill(result_.first(2 * size), 0);
+
+    // Cross products value[i] * value[j] with i < j
+    for (size_t index = 0; index < size; ++index) {
+        const underlying_type lhs_value = value_[index];
+        underlying_type overflow = 0;
+        size_t result_index = 2 * index + 1;
+        for (size_t other_index = index + 1; other_index < size; ++other_index) {
+            result_[result_index] = multiply_add(lhs_value, value_[other_index], result_[result_index], overflow);
+            ++result_index;
+        }
 
-[[nodiscard]] const large_unsigned_integer::collection_type& large_unsigned_integer::get_data() const {
-    return data;
-}
+        if (index + 1 < size) {
+            result_[result_index] = overflow;
+        }
+    }
 
-// ----------------------------------------------------------------------------
+    // Double the cross products
+    underlying_type shifted_out = 0;
+    for (auto& value : result_.first(2 * size)) {
+        const underlying_type new_shifted_out = value >> (nb_extended_type_bits - 1);
+        value = static_cast<underlying_type>(value << 1) | shifted_out;
+        shifted_out = new_shifted_out;
+    }
 
-namespace details {
+    // Add the diagonal
+    bool carry = false;
+    for (size_t index = 0; index < size; ++index) {
+        underlying_type high = 0;
+        const underlying_type low = multiply_add(value_[index], value_[index], 0, high);
 
-using extended_type = large_unsigned_integer::extended_type;
+        result_[2 * index] = add_with_carry(result_[2 * index], low, carry);
+        result_[2 * index + 1] = add_with_carry(result_[2 * index + 1], high, carry);
+    }
 
-// ----------------------------------------------------------------------------
+    assert(!carry);
+}
 
-// Perform division of large number represented as a string
-[[nodiscard]] std::string divide_integer_as_string_by_integer(const std::string& number_, extended_type divisor_) {
-    assert(!number_.empty());
+// ------------------------------------------------------------------------
+// lhs = lhs1 * B^half + lhs0, rhs = rhs1 * B^half + rhs0
+// lhs * rhs = z2 * B^(2 * half) + (z1 - z2 - z0) * B^half + z0
+// with z0 = lhs0 * rhs0, z2 = lhs1 * rhs1 and z1 = (lhs0 + lhs1) * (rhs0 + rhs1)
+void multiply_karatsuba(limbs_span result_, limbs_view lhs_, limbs_view rhs_) {
+    const bool square = is_square(lhs_, rhs_);
+    assert(lhs_.size() >= rhs_.size());
+
+    const size_t half = (lhs_.size() + 1) / 2;
+    assert(rhs_.size() > half);
+
+    const auto lhs0 = lhs_.first(half);
+    const auto lhs1 = lhs_.subspan(half);
+    const auto rhs0 = rhs_.first(half);
+    const auto rhs1 = rhs_.subspan(half);
+
+    // z0 and z2 are written directly at their final position
+    const auto z0 = result_.first(2 * half);
+    const auto z2 = result_.subspan(2 * half, lhs_.size() + rhs_.size() - 2 * half);
+
+    const auto lhs_sum = add(lhs0, lhs1);
+    const auto rhs_sum = square ? collection_type{} : add(rhs0, rhs1);
+    collection_type z1(2 * lhs_sum.size(), 0);
+
+    // The 3 products are independent
+    const auto compute_product = [&](size_t index_) {
+        switch (index_) {
+        case 0:
+            multiply(z0, lhs0, square ? lhs0 : rhs0);
+            break;
+        case 1:
+            multiply(z2, lhs1, square ? lhs1 : rhs1);
+            break;
+        default:
+            multiply(z1, lhs_sum, square ? limbs_view(lhs_sum) : limbs_view(rhs_sum));
+            break;
+        }
+    };
 
-    // Find prefix of number that is larger than divisor.
-    extended_type sum{ 0 };
-    auto it = std::ranges::find_if(number_, [&sum, divisor_](char c) {
-        sum = sum * 10 + (c - '0');
-        return sum >= divisor_;
-    });
+    if (is_parallel(rhs_.size(), parallel_multiplication_threshold)) {
+        parallel_for(3, compute_product);
+    } else {
+        for (size_t index = 0; index < 3; ++index) {
+            compute_product(index);
+        }
+    }
+
+    [[maybe_unused]] const bool borrow0 = subtract_in_place(z1, z0);
+    [[maybe_unused]] const bool borrow2 = subtract_in_place(z1, z2);
+    assert(!borrow0 && !borrow2);
+
+    [[maybe_unused]] const bool overflow = add_in_place(result_.subspan(half, lhs_.size() + rhs_.size() - half), trimmed(z1));
+    assert(!overflow);
+}
+
+// ------------------------------------------------------------------------
+// Signed value used by the Toom-Cook interpolation
+struct signed_large_unsigned_integer {
+    collection_type magnitude;
+    bool negative = false;
+};
 
-    const auto next_char = to_char(sum / divisor_);
-    std::string result({ next_char });
-    result.reserve(number_.size());
+[[nodiscard]] signed_large_unsigned_integer add(signed_large_unsigned_integer lhs_, const signed_large_unsigned_integer& rhs_) {
+    if (lhs_.negative == rhs_.negative) {
+        add_large_unsigned_integer_in_place(lhs_.magnitude, rhs_.magnitude);
+        return lhs_;
+    }
 
-    if (it == std::end(number_)) {
+    if (compare_large_unsigned_integer(lhs_.magnitude, rhs_.magnitude) == std::strong_ordering::less) {
+        auto result = rhs_;
+        subtract_large_unsigned_integer_in_place(result.magnitude, lhs_.magnitude);
         return result;
     }
 
-    std::ranges::transform(++it, std::end(number_), std::back_inserter(result), [&sum, divisor_](char c) {
-        sum = (sum % divisor_) * 10 + to_value(c);
-        const auto next_char = to_char(sum / divisor_);
-        return next_char;
-    });
+    subtract_large_unsigned_integer_in_place(lhs_.magnitude, rhs_.magnitude);
+    lhs_.negative = lhs_.negative && !lhs_.magnitude.empty();
+    return lhs_;
+}
 
-    return result;
+[[nodiscard]] signed_large_unsigned_integer subtract(signed_large_unsigned_integer lhs_, signed_large_unsigned_integer rhs_) {
+    rhs_.negative = !rhs_.negative && !rhs_.magnitude.empty();
+    return add(std::move(lhs_), rhs_);
 }
 
-// ----------------------------------------------------------------------------
+[[nodiscard]] signed_large_unsigned_integer multiply(const signed_large_unsigned_integer& lhs_, const signed_large_unsigned_integer& rhs_) {
+    const bool square = &lhs_ == &rhs_;
+    if (lhs_.magnitude.empty() || rhs_.magnitude.empty()) {
+        return {};
+    }
 
-[[nodiscard]] extended_type modulo_integer_as_string_by_integer(const std::string& number_, extended_type divisor_) {
-    extended_type result = 0;
+    signed_large_unsigned_integer result{ collection_type(lhs_.magnitude.size() + rhs_.magnitude.size(), 0), lhs_.negative != rhs_.negative };
+    multiply(result.magnitude, lhs_.magnitude, square ? limbs_view(lhs_.magnitude) : limbs_view(rhs_.magnitude));
+    trim_upper_zeros(result.magnitude);
+    return result;
+}
 
-    // Sequencially apply modulo
-    for (const auto digit : number_) {
-        result = (result * 10 + to_value(digit)) % divisor_;
+// Exact division by a small value
+[[nodiscard]] signed_large_unsigned_integer divide_exact(signed_large_unsigned_integer value_, underlying_type divisor_) {
+    extended_type remainder{ 0 };
+    for (auto& limb : value_.magnitude | std::views::reverse) {
+        const extended_type current = (remainder << nb_extended_type_bits) | limb;
+        limb = static_cast<underlying_type>(current / divisor_);
+        remainder = current % divisor_;
     }
 
-    return result;
+    assert(remainder == 0);
+    trim_upper_zeros(value_.magnitude);
+    value_.negative = value_.negative && !value_.magnitude.empty();
+    return value_;
 }
 
-// ----------------------------------------------------------------------------
+[[nodiscard]] signed_large_unsigned_integer twice(signed_large_unsigned_integer value_) {
+    add_large_unsigned_integer_in_place(value_.magnitude, value_.magnitude);
+    return value_;
+}
 
-[[nodiscard]] bool is_number_well_formed(const std::string& str_) {
-    unsigned int dot_counter = 0;
+// ------------------------------------------------------------------------
+// Toom-Cook 3 with the evaluation points 0, 1, -1, -2 and infinity and Bodrato's interpolation sequence
+void multiply_toom_3(limbs_span result_, limbs_view lhs_, limbs_view rhs_) {
+    const bool square = is_square(lhs_, rhs_);
+    assert(lhs_.size() >= rhs_.size());
+
+    const size_t part_size = (lhs_.size() + 2) / 3;
+    assert(rhs_.size() > 2 * part_size);
+
+    const auto split = [part_size](limbs_view value_) {
+        std::array<signed_large_unsigned_integer, 3> parts;
+        for (size_t index = 0; index < 3; ++index) {
+            const auto part = trimmed(value_.subspan(index * part_size, std::min(part_size, value_.size() - index * part_size)));
+            parts[index].magnitude.assign(part.begin(), part.end());
+        }
+        return parts;
+    };
+
+    // p(0), p(1), p(-1), p(-2), p(inf)
+    const auto evaluate = [](const std::array<signed_large_unsigned_integer, 3>& parts_) {
+        const auto p0 = add(parts_[0], parts_[2]);
+        const auto p1 = add(p0, parts_[1]);
+        const auto p_1 = subtract(p0, parts_[1]);
+        const auto p_2 = subtract(twice(add(p_1, parts_[2])), parts_[0]);
+        return std::array<signed_large_unsigned_integer, 5>{ parts_[0], p1, p_1, p_2, parts_[2] };
+    };
+
+    const auto lhs_values = evaluate(split(lhs_));
+    const auto rhs_values = square ? std::array<signed_large_unsigned_integer, 5>{} : evaluate(split(rhs_));
+
+    // The 5 products are independent
+    std::array<signed_large_unsigned_integer, 5> values;
+    const auto compute_product = [&](size_t index_) {
+        values[index_] = multiply(lhs_values[index_], square ? lhs_values[index_] : rhs_values[index_]);
+    };
+
+    if (is_parallel(rhs_.size(), parallel_multiplication_threshold)) {
+        parallel_for(values.size(), compute_product);
+    } else {
+        for (size_t index = 0; index < values.size(); ++index) {
+            compute_product(index);
+        }
+    }
 
-    return std::ranges::all_of(str_, [&dot_counter](auto digit) {
-        // This assume a locale that split number using '.'
-        if (digit == '.') {
-            ++dot_counter;
-            return dot_counter == 1;    // Must have only one '.'
+    // Interpolation
+    const auto& r0 = values[0];
+    const auto& r4 = values[4];
+    auto r3 = divide_exact(subtract(values[3], values[1]), 3);
+    auto r1 = divide_exact(subtract(values[1], values[2]), 2);
+    auto r2 = subtract(values[2], values[0]);
+    r3 = add(divide_exact(subtract(r2, r3), 2), twice(values[4]));
+    r2 = subtract(add(r2, r1), r4);
+    r1 = subtract(r1, r3);
+
+    // Recomposition
+    std::ranges::fill(result_.first(lhs_.size() + rhs_.size()), 0);
+    const auto total_size = lhs_.size() + rhs_.size();
+    size_t offset = 0;
+    for (const auto* coefficient : std::array<const signed_large_unsigned_integer*, 5>{ &r0, &r1, &r2, &r3, &r4 }) {
+        assert(!coefficient->negative);
+        if (!coefficient->magnitude.empty()) {
+            [[maybe_unused]] const bool overflow = add_in_place(result_.subspan(offset, total_size - offset), coefficient->magnitude);
+            assert(!overflow);
         }
+        offset += part_size;
+    }
+}
 
-        return std::isdigit(digit) != 0;
-    });
+// ------------------------------------------------------------------------
+// Number-theoretic transform over 3 NTT friendly primes, combined with the
+// Chinese remainder theorem. Limbs are split into 16-bit coefficients so that
+// every coefficient of the convolution is smaller than the product of the primes
+namespace ntt {
+
+using coefficient_type = std::uint32_t;
+
+constexpr const unsigned int nb_coefficient_bits = 16;
+constexpr const unsigned int nb_coefficients_per_limb = nb_extended_type_bits / nb_coefficient_bits;
+constexpr const std::array<std::uint32_t, 3> moduli{ 998244353, 167772161, 469762049 };
+constexpr const std::uint32_t primitive_root = 3; // Shared by the 3 primes
+
+// The largest power of 2 dividing every modulus - 1
+constexpr const size_t max_size = size_t{ 1 } << 23;
+
+[[nodiscard]] constexpr std::uint32_t power_modulo(std::uint64_t base_, std::uint64_t exponent_, std::uint32_t modulus_) {
+    std::uint64_t result = 1;
+    base_ %= modulus_;
+    while (exponent_ > 0) {
+        if (exponent_ & 1) {
+            result = result * base_ % modulus_;
+        }
+        base_ = base_ * base_ % modulus_;
+        exponent_ >>= 1;
+    }
+    return static_cast<std::uint32_t>(result);
 }
 
-} // namespace details
+// In place iterative Cooley-Tukey transform, the modulus is a template parameter
+// so that the compiler replaces the modulo operations by multiplications
+template<std::uint32_t modulus>
+void transform(std::vector<coefficient_type>& data_, bool inverse_) {
+    const size_t size = data_.size();
 
-// ----------------------------------------------------------------------------
+    for (size_t index = 1, reversed = 0; index < size; ++index) {
+        size_t bit = size >> 1;
+        for (; reversed & bit; bit >>= 1) {
+            reversed ^= bit;
+        }
+        reversed ^= bit;
 
-[[nodiscard]] std::optional<large_unsigned_integer> large_unsigned_integer::from_string(const std::string& str_) {
-    assert(!str_.empty());
-    if (str_.empty()) {
-        return {};
+        if (index < reversed) {
+            std::swap(data_[index], data_[reversed]);
+        }
     }
 
-    const bool well_formed = details::is_number_well_formed(str_);
+    std::vector<coefficient_type> factors(size / 2);
+    for (size_t length = 2; length <= size; length <<= 1) {
+        std::uint64_t root = power_modulo(primitive_root, (modulus - 1) / length, modulus);
+        if (inverse_) {
+            root = power_modulo(root, modulus - 2, modulus);
+        }
 
-    assert(well_formed);
-    if (!well_formed) {
-        return {};
-    }
+        // Powers of the root shared by every block of this stage
+        const size_t half_length = length / 2;
+        factors[0] = 1;
+        for (size_t index = 1; index < half_length; ++index) {
+            factors[index] = static_cast<coefficient_type>(factors[index - 1] * root % modulus);
+        }
 
-    std::string number = str_;
+        for (size_t start = 0; start < size; start += length) {
+            for (size_t index = 0; index < half_length; ++index) {
+                const std::uint32_t even = data_[start + index];
+                const auto odd = static_cast<std::uint32_t>(std::uint64_t{ data_[start + index + half_length] } * factors[index] % modulus);
 
-    std::vector<large_unsigned_integer::underlying_type> data;
-    do {
-        data.emplace_back(static_cast<large_unsigned_integer::underlying_type>(
-            details::modulo_integer_as_string_by_integer(number,
-                large_unsigned_integer::base)));
-        number = details::divide_integer_as_string_by_integer(number,
-            large_unsigned_integer::base);
-    } while (number != "0");
+                const std::uint32_t sum = even + odd;
+                data_[start + index] = (sum >= modulus) ? sum - modulus : sum;
+                data_[start + index + half_length] = (even >= odd) ? even - odd : even + modulus - odd;
+            }
+        }
+    }
 
-    return std::make_optional<large_unsigned_integer>(data);
+    if (inverse_) {
+        const std::uint64_t inverse_size = power_modulo(size, modulus - 2, modulus);
+        for (auto& value : data_) {
+            value = static_cast<coefficient_type>(value * inverse_size % modulus);
+        }
+    }
 }
 
-// ----------------------------------------------------------------------------
+[[nodiscard]] std::vector<coefficient_type> to_coefficients(limbs_view data_, size_t size_) {
+    std::vector<coefficient_type> coefficients(size_, 0);
+    for (size_t index = 0; index < data_.size(); ++index) {
+        for (unsigned int part = 0; part < nb_coefficients_per_limb; ++part) {
+            coefficients[index * nb_coefficients_per_limb + part] = static_cast<coefficient_type>((data_[index] >> (part * nb_coefficient_bits)) & 0xFFFF);
+        }
+    }
+    return coefficients;
+}
 
-namespace details {
+template<std::uint32_t modulus>
+[[nodiscard]] std::vector<coefficient_type> convolution(limbs_view lhs_, limbs_view rhs_, size_t size_) {
+    auto lhs = to_coefficients(lhs_, size_);
+    transform<modulus>(lhs, false);
 
-[[nodiscard]] inline std::tuple<std::string, extended_type> add_integers(std::string&& sum_, extended_type lhs_, extended_type rhs_, extended_type carry_) {
-    const auto digitSum = lhs_ + rhs_ + carry_;
-    carry_ = digitSum / 10;
+    if (is_square(lhs_, rhs_)) {
+        for (auto& value : lhs) {
+            value = static_cast<coefficient_type>(std::uint64_t{ value } * value % modulus);
+        }
+    } else {
+        auto rhs = to_coefficients(rhs_, size_);
+        transform<modulus>(rhs, false);
+        for (size_t index = 0; index < size_; ++index) {
+            lhs[index] = static_cast<coefficient_type>(std::uint64_t{ lhs[index] } * rhs[index] % modulus);
+        }
+    }
 
-    // String is constructed in reverse
-    sum_ += to_char(digitSum % 10);
-    return { sum_, carry_ };
+    transform<modulus>(lhs, true);
+    return lhs;
 }
 
-// ----------------------------------------------------------------------------
+[[nodiscard]] constexpr size_t transform_size(limbs_view lhs_, limbs_view rhs_) {
+    return std::bit_ceil((lhs_.size() + rhs_.size()) * nb_coefficients_per_limb);
+}
 
-// Function to add two strings representing large integers
-[[nodiscard]] std::string add_integers_as_string(const std::string& lhs_, const std::string& rhs_) {
-    assert(!lhs_.empty() && !rhs_.empty());
+} // namespace ntt
+
+void multiply_ntt(limbs_span result_, limbs_view lhs_, limbs_view rhs_) {
+    using namespace ntt;
+
+    const size_t size = transform_size(lhs_, rhs_);
+    assert(size <= max_size);
+
+    // The 3 convolutions are independent
+    std::array<std::vector<coefficient_type>, 3> residues;
+    const auto compute_residues = [&](size_t index_) {
+        switch (index_) {
+        case 0:
+            residues[0] = convolution<moduli[0]>(lhs_, rhs_, size);
+            break;
+        case 1:
+            residues[1] = convolution<moduli[1]>(lhs_, rhs_, size);
+            break;
+        default:
+            residues[2] = convolution<moduli[2]>(lhs_, rhs_, size);
+            break;
+        }
+    };
 
-    if (lhs_.size() < rhs_.size()) {
-        return add_integers_as_string(rhs_, lhs_);
+    if (is_parallel(rhs_.size(), parallel_multiplication_threshold)) {
+        parallel_for(residues.size(), compute_residues);
+    } else {
+        for (size_t index = 0; index < residues.size(); ++index) {
+            compute_residues(index);
+        }
     }
 
-    extended_type carry = 0;
-    std::string sum;
-    sum.reserve(lhs_.size() + 1);
+    const auto& [residues0, residues1, residues2] = residues;
 
-    // Add rhs digits
-#if defined(__cpp_lib_ranges_zip) && __cpp_lib_ranges_zip >= 202110L
-    for (const auto [lhs_digit, rhs_digit] : std::views::zip(lhs_, rhs_)) {
-#else
-    for (size_t index = 0; index < rhs_.size(); ++index) {
-        const auto lhs_digit = to_value(lhs_[index]);
-        const auto rhs_digit = to_value(rhs_[index]);
-#endif
-        std::tie(sum, carry) = add_integers(std::move(sum), lhs_digit, rhs_digit, carry);
-}
+    // Garner's algorithm
+    constexpr const std::uint64_t m0 = moduli[0];
+    constexpr const std::uint64_t m1 = moduli[1];
+    constexpr const std::uint64_t m2 = moduli[2];
+    constexpr const std::uint64_t inverse_m0_mod_m1 = power_modulo(m0, m1 - 2, m1);
+    constexpr const std::uint64_t inverse_m0m1_mod_m2 = power_modulo(m0 * m1 % m2, m2 - 2, m2);
 
-    // Propagate carry to lhs
-    for (const auto lhs_char : lhs_ | std::views::drop(rhs_.size())) {
-        const auto lhs_digit = to_value(lhs_char);
-        constexpr const auto rhs_digit = 0;
+    std::ranges::fill(result_.first(lhs_.size() + rhs_.size()), 0);
 
-        std::tie(sum, carry) = add_integers(std::move(sum), lhs_digit, rhs_digit, carry);
-    }
+    using wide_type = unsigned __int128;
+    wide_type carry = 0;
+    for (size_t index = 0; index < (lhs_.size() + rhs_.size()) * nb_coefficients_per_limb; ++index) {
+        const std::uint64_t x0 = residues0[index];
+        const std::uint64_t x1 = (residues1[index] + m1 - x0 % m1) % m1 * inverse_m0_mod_m1 % m1;
+        const std::uint64_t x2 = (residues2[index] + m2 - (x0 + x1 * m0) % m2) % m2 * inverse_m0m1_mod_m2 % m2;
 
-    // Propagate carry
-    if (carry > 0) {
-        constexpr const auto lhs_digit = 0;
-        constexpr const auto rhs_digit = 0;
-        std::tie(sum, carry) = add_integers(std::move(sum), lhs_digit, rhs_digit, carry);
+        carry += x0 + wide_type{ x1 } * m0 + wide_type{ x2 } * m0 * m1;
+
+        const auto coefficient = static_cast<underlying_type>(carry & 0xFFFF);
+        carry >>= nb_coefficient_bits;
+
+        result_[index / nb_coefficients_per_limb] |= coefficient << ((index % nb_coefficients_per_limb) * nb_coefficient_bits);
     }
 
     assert(carry == 0);
-
-    auto reversed = std::views::reverse(sum);
-    return { std::begin(reversed), std::end(reversed) };
 }
 
-// ----------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+// Split the largest operand in chunks the size of the smallest one
+void multiply_unbalanced(limbs_span result_, limbs_view lhs_, limbs_view rhs_) {
+    std::ranges::fill(result_.first(lhs_.size() + rhs_.size()), 0);
+
+    // The chunk products are computed at once in parallel then accumulated
+    if (is_parallel(rhs_.size(), parallel_multiplication_threshold)) {
+        const size_t nb_chunks = (lhs_.size() + rhs_.size() - 1) / rhs_.size();
+        std::vector<collection_type> products(nb_chunks);
+        parallel_for(nb_chunks, [&](size_t index_) {
+            const auto chunk = lhs_.subspan(index_ * rhs_.size(), std::min(rhs_.size(), lhs_.size() - index_ * rhs_.size()));
+            products[index_] = collection_type(chunk.size() + rhs_.size(), 0);
+            multiply(products[index_], chunk, rhs_);
+        });
+
+        for (size_t index = 0; index < nb_chunks; ++index) {
+            const size_t offset = index * rhs_.size();
+            [[maybe_unused]] const bool overflow = add_in_place(result_.subspan(offset, lhs_.size() + rhs_.size() - offset), products[index]);
+            assert(!overflow);
+        }
+        return;
+    }
 
-// Function to multiply a string representing a large integer by an integer
-[[nodiscard]] std::string multiply_integer_as_string_by_integer(const std::string & num_, large_unsigned_integer::extended_type factor_) {
-    std::string result;
-    large_unsigned_integer::extended_type carry = 0;
-    for (auto digit_str : std::views::reverse(num_)) {
-        large_unsigned_integer::extended_type digit = digit_str - '0';
-        large_unsigned_integer::extended_type product = digit * factor_ + carry;
-        carry = product / 10;
-        result = std::to_string(product % 10) + result;
+    collection_type product(2 * rhs_.size(), 0);
+    for (size_t offset = 0; offset < lhs_.size(); offset += rhs_.size()) {
+        const auto chunk = lhs_.subspan(offset, std::min(rhs_.size(), lhs_.size() - offset));
+        const auto chunk_product = limbs_span(product).first(chunk.size() + rhs_.size());
+        multiply(chunk_product, chunk, rhs_);
+
+        [[maybe_unused]] const bool overflow = add_in_place(result_.subspan(offset, lhs_.size() + rhs_.size() - offset), chunk_product);
+        assert(!overflow);
     }
+}
 
-    if (carry > 0) {
-        result = std::to_string(carry) + result;
+// ------------------------------------------------------------------------
+// Select the multiplication algorithm according to the size of the operands
+void multiply(limbs_span result_, limbs_view lhs_, limbs_view rhs_) {
+    if (lhs_.size() < rhs_.size()) {
+        std::swap(lhs_, rhs_);
     }
 
-    return result;
-}
+    assert(result_.size() >= lhs_.size() + rhs_.size());
 
-// ----------------------------------------------------------------------------
+    const bool square = is_square(lhs_, rhs_);
+    const size_t size = rhs_.size();
 
-// Recompose data, where values are represented as data[i]*base^i, into a base 10 string
-[[nodiscard]] std::string recompose_data_as_base_10_string(const large_unsigned_integer::collection_type & data_, large_unsigned_integer::extended_type base_) {
-    std::string result = "0";
-    unsigned int power = 0;
-    for (auto single_data : data_) {
-        // Multiply the current element by the large_unsigned_integer base
-        std::string temp = std::to_string(single_data);
-        for (size_t j = 0; j < power; ++j) {
-            temp = multiply_integer_as_string_by_integer(temp, base_);
+    if (size < karatsuba_threshold.load(std::memory_order_relaxed)) {
+        if (square) {
+            square_schoolbook(result_, lhs_);
+        } else {
+            multiply_schoolbook(result_, lhs_, rhs_);
         }
-        ++power;
-        // Add the current number to the result
-        result = add_integers_as_string(result, temp);
+    } else if (size >= ntt_threshold.load(std::memory_order_relaxed) && ntt::transform_size(lhs_, rhs_) <= ntt::max_size) {
+        multiply_ntt(result_, lhs_, rhs_);
+    } else if (size <= (lhs_.size() + 1) / 2) {
+        multiply_unbalanced(result_, lhs_, rhs_);
+    } else if (size >= toom_3_threshold.load(std::memory_order_relaxed) && size > 2 * ((lhs_.size() + 2) / 3)) {
+        multiply_toom_3(result_, lhs_, rhs_);
+    } else {
+        multiply_karatsuba(result_, lhs_, rhs_);
     }
-    return result;
 }
 
-    } // namespace details
+// ------------------------------------------------------------------------
+// Helper function that multiply 2 sorted large unsigned intergers
+[[nodiscard]] collection_type multiply_large_unsigned_integer_sorted(const collection_type& lhs_, const collection_type& rhs_) {
+    if (lhs_.empty() || rhs_.empty()) {
+        return {};
+    }
+
+    collection_type result_data(lhs_.size() + rhs_.size(), 0);
+    multiply(result_data, lhs_, is_square(lhs_, rhs_) ? limbs_view(lhs_) : limbs_view(rhs_));
 
-    // ----------------------------------------------------------------------------
+    return cleanup(std::move(result_data));
+}
 
-[[nodiscard]] std::string to_string(const large_unsigned_integer& value_) {
-    return details::recompose_data_as_base_10_string(value_.get_data(), large_unsigned_integer::base);
+// ------------------------------------------------------------------------
+// Helper function that shift the data toward the most significant limbs
+void shift_left_large_unsigned_integer_in_place(collection_type& data_, size_t nb_bits_) {
+    if (data_.empty()) {
+        return;
+    }
+
+    const size_t limb_shift = nb_bits_ / nb_extended_type_bits;
+    const auto bit_shift = static_cast<unsigned int>(nb_bits_ % nb_extended_type_bits);
+
+    const size_t old_size = data_.size();
+    data_.resize(old_size + limb_shift + 1, 0);
+
+    // Move from the top to avoid overwriting limbs not yet shifted
+    for (size_t index = old_size; index > 0; --index) {
+        const extended_type value = extended_type{ data_[index - 1] } << bit_shift;
+        data_[index - 1 + limb_shift + 1] |= static_cast<underlying_type>(value >> nb_extended_type_bits);
+        data_[index - 1 + limb_shift] = static_cast<underlying_type>(value);
+    }
+
+    std::fill_n(data_.begin(), limb_shift, 0);
+
+    cleanup_in_place(data_);
+}
+
+// ------------------------------------------------------------------------
+// Helper function that shift the data toward the least significant limbs
+void shift_right_large_unsigned_integer_in_place(collection_type& data_, size_t nb_bits_) {
+    const size_t limb_shift = nb_bits_ / nb_extended_type_bits;
+    if (limb_shift >= data_.size()) {
+        data_.clear();
+        return;
+    }
+
+    const auto bit_shift = static_cast<unsigned int>(nb_bits_ % nb_extended_type_bits);
+
+    const size_t new_size = data_.size() - limb_shift;
+    for (size_t index = 0; index < new_size; ++index) {
+        const extended_type high = (index + limb_shift + 1 < data_.size()) ? data_[index + limb_shift + 1] : 0;
+        const extended_type value = (high << nb_extended_type_bits) | data_[index + limb_shift];
+        data_[index] = static_cast<underlying_type>(value >> bit_shift);
+    }
+
+    data_.resize(new_size);
+
+    cleanup_in_place(data_);
+}
+
+// ------------------------------------------------------------------------
+// Value of value_ * 2^(nb_bits_ - shift_)
+[[nodiscard]] large_unsigned_integer scale(const large_unsigned_integer& value_, size_t nb_bits_, size_t shift_) {
+    return (nb_bits_ >= shift_) ? value_ << (nb_bits_ - shift_) : value_ >> (shift_ - nb_bits_);
+}
+
+// ------------------------------------------------------------------------
+// Number of limbs of the divisor from which the division uses Barrett's method
+// with a Newton reciprocal instead of Knuth's algorithm D (measured for a
+// dividend twice as large as the divisor, with the vectorized kernels)
+constexpr const size_t barrett_division_threshold = 8192;
+
+// ------------------------------------------------------------------------
+// Helper function that divide the data by a single limb in place, return the remainder
+[[nodiscard]] underlying_type divide_large_unsigned_integer_by_limb_in_place(collection_type& data_, underlying_type divisor_) {
+    assert(divisor_ != 0);
+
+    extended_type remainder{ 0 };
+    for (auto& limb : data_ | std::views::reverse) {
+        const extended_type current = (remainder << nb_extended_type_bits) | limb;
+        limb = static_cast<underlying_type>(current / divisor_);
+        remainder = current % divisor_;
+    }
+
+    cleanup_in_place(data_);
+    return static_cast<underlying_type>(remainder);
+}
+
+// ------------------------------------------------------------------------
+// Knuth's algorithm D (TAOCP vol. 2, 4.3.1), the divisor has at least 2 limbs and is not larger than the dividend
+[[nodiscard]] std::pair<collection_type, collection_type> divide_knuth(const collection_type& dividend_, const collection_type& divisor_) {
+    assert(divisor_.size() >= 2 && sorted(dividend_, divisor_));
+
+    // Normalize the divisor so that its top bit is set, the estimate of each
+    // quotient limb from the top limbs is then at most 2 units too large
+    const auto shift = static_cast<size_t>(std::countl_zero(divisor_.back()));
+    collection_type divisor = divisor_;
+    shift_left_large_unsigned_integer_in_place(divisor, shift);
+    collection_type remainder = dividend_;
+    shift_left_large_unsigned_integer_in_place(remainder, shift);
+    remainder.resize(dividend_.size() + 1, 0);
+
+    const size_t size = divisor.size();
+    const extended_type top = divisor[size - 1];
+    const extended_type second = divisor[size - 2];
+
+    collection_type quotient(dividend_.size() - size + 1, 0);
+    collection_type product(size + 1, 0);
+    for (size_t index = quotient.size(); index-- > 0;) {
+        const extended_type numerator = (extended_type{ remainder[index + size] } << nb_extended_type_bits) | remainder[index + size - 1];
+        extended_type estimate = numerator / top;
+        extended_type estimate_remainder = numerator % top;
+        while (estimate >= base || estimate * second > ((estimate_remainder << nb_extended_type_bits) | remainder[index + size - 2])) {
+            --estimate;
+            estimate_remainder += top;
+            if (estimate_remainder >= base) {
+                break;
+            }
+        }
+
+        // Multiply and subtract, the estimate can still be one unit too large
+        auto digit = static_cast<underlying_type>(estimate);
+        product[size] = get_kernels().multiply_add(product.data(), divisor.data(), size, digit, 0);
+        if (get_kernels().subtract(&remainder[index], &remainder[index], product.data(), size + 1, false)) {
+            --digit;
+            remainder[index + size] += get_kernels().add(&remainder[index], &remainder[index], divisor.data(), size, false);
+        }
+
+        quotient[index] = digit;
+    }
+
+    remainder.resize(size);
+    shift_right_large_unsigned_integer_in_place(remainder, shift);
+    return { cleanup(std::move(quotient)), cleanup(std::move(remainder)) };
+}
+
+// ------------------------------------------------------------------------
+// Barrett's method, the normalized divisor d has L limbs and the dividend is processed
+// by chunks of L limbs so that every partial dividend is below d * 2^(L * bits) <= 2^(2w).
+// The quotient of each chunk then only costs 2 multiplications by floor(2^(2w) / d)
+[[nodiscard]] std::pair<collection_type, collection_type> divide_barrett(const collection_type& dividend_, const collection_type& divisor_) {
+    assert(divisor_.size() >= 2 && sorted(dividend_, divisor_));
+
+    const auto shift = static_cast<size_t>(std::countl_zero(divisor_.back()));
+    collection_type normalized_divisor = divisor_;
+    shift_left_large_unsigned_integer_in_place(normalized_divisor, shift);
+    collection_type dividend = dividend_;
+    shift_left_large_unsigned_integer_in_place(dividend, shift);
+
+    const size_t chunk_size = normalized_divisor.size();
+    const size_t width = chunk_size * nb_extended_type_bits;
+    const large_unsigned_integer divisor(std::move(normalized_divisor));
+    const auto reciprocal = details::compute_reciprocal(divisor);
+
+    collection_type quotient(dividend.size(), 0);
+    large_unsigned_integer remainder;
+    for (size_t begin = (dividend.size() - 1) / chunk_size * chunk_size + chunk_size; begin >= chunk_size;) {
+        begin -= chunk_size;
+
+        // remainder * 2^(L * bits) + chunk
+        collection_type current_data(chunk_size, 0);
+        std::copy(dividend.begin() + begin, dividend.begin() + std::min(begin + chunk_size, dividend.size()), current_data.begin());
+        current_data.resize(chunk_size + remainder.get_data().size());
+        std::ranges::copy(remainder.get_data(), current_data.begin() + chunk_size);
+        const large_unsigned_integer current(std::move(current_data));
+
+        // The estimate is never larger than the quotient and at most 2 units smaller
+        auto chunk_quotient = ((current >> (width - 1)) * reciprocal) >> (width + 1);
+        remainder = current - chunk_quotient * divisor;
+        while (remainder >= divisor) {
+            remainder -= divisor;
+            chunk_quotient += 1u;
+        }
+
+        std::ranges::copy(chunk_quotient.get_data(), quotient.begin() + begin);
+    }
+
+    collection_type remainder_data = remainder.get_data();
+    shift_right_large_unsigned_integer_in_place(remainder_data, shift);
+    return { cleanup(std::move(quotient)), std::move(remainder_data) };
+}
+
+// ------------------------------------------------------------------------
+// Helper function that compute the quotient and the remainder
+[[nodiscard]] std::pair<collection_type, collection_type> divide_large_unsigned_integer(const collection_type& dividend_, const collection_type& divisor_) {
+    if (divisor_.empty()) {
+        throw std::domain_error("Division by zero");
+    }
+
+    if (compare_large_unsigned_integer(dividend_, divisor_) == std::strong_ordering::less) {
+        return { collection_type{}, dividend_ };
+    }
+
+    if (divisor_.size() == 1) {
+        collection_type quotient = dividend_;
+        const underlying_type remainder = divide_large_unsigned_integer_by_limb_in_place(quotient, divisor_.front());
+        return { std::move(quotient), cleanup(collection_type{ remainder }) };
+    }
+
+    if (divisor_.size() >= barrett_division_threshold) {
+        return divide_barrett(dividend_, divisor_);
+    }
+
+    return divide_knuth(dividend_, divisor_);
+}
+
+} // Anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void large_unsigned_integer::set_storage_policy(storage_policy policy_) {
+    current_storage_policy.store(policy_, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer::storage_policy large_unsigned_integer::get_storage_policy() {
+    return current_storage_policy.load(std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+void large_unsigned_integer::set_multiplication_thresholds(multiplication_thresholds thresholds_) {
+    // The recursive algorithms need operands large enough to split them into smaller ones
+    constexpr const size_t min_karatsuba_threshold = 4;
+    constexpr const size_t min_toom_3_threshold = 9;
+
+    karatsuba_threshold.store(std::max(thresholds_.karatsuba, min_karatsuba_threshold), std::memory_order_relaxed);
+    toom_3_threshold.store(std::max(thresholds_.toom_3, min_toom_3_threshold), std::memory_order_relaxed);
+    ntt_threshold.store(thresholds_.ntt, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer::multiplication_thresholds large_unsigned_integer::get_multiplication_thresholds() {
+    return {
+        karatsuba_threshold.load(std::memory_order_relaxed),
+        toom_3_threshold.load(std::memory_order_relaxed),
+        ntt_threshold.load(std::memory_order_relaxed),
+    };
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// Average duration in seconds of a multiplication of 2 random operands of size_ limbs
+[[nodiscard]] double time_multiplication(auto kernel_, size_t size_) {
+    std::mt19937_64 engine(size_);
+    std::uniform_int_distribution<underlying_type> distribution;
+
+    collection_type lhs(size_);
+    collection_type rhs(size_);
+    std::ranges::generate(lhs, [&] { return distribution(engine); });
+    std::ranges::generate(rhs, [&] { return distribution(engine); });
+    collection_type result(2 * size_);
+
+    constexpr const auto min_duration = std::chrono::milliseconds(5);
+    const auto start = std::chrono::steady_clock::now();
+    size_t nb_repetitions = 0;
+    std::chrono::duration<double> duration{};
+    do {
+        kernel_(limbs_span(result), limbs_view(lhs), limbs_view(rhs));
+        ++nb_repetitions;
+        duration = std::chrono::steady_clock::now() - start;
+    } while (duration < min_duration);
+
+    return duration.count() / static_cast<double>(nb_repetitions);
+}
+
+// Smallest size, from begin_ to end_, where candidate_ is faster than reference_
+[[nodiscard]] std::optional<size_t> find_crossover(auto candidate_, auto reference_, size_t begin_, size_t end_) {
+    for (size_t size = begin_; size <= end_; size += std::max<size_t>(size / 4, 1)) {
+        if (time_multiplication(candidate_, size) < time_multiplication(reference_, size)) {
+            return size;
+        }
+    }
+    return {};
+}
+
+} // Anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer::multiplication_thresholds large_unsigned_integer::benchmark_multiplication_thresholds() {
+    const auto previous_thresholds = get_multiplication_thresholds();
+
+    constexpr const auto never = std::numeric_limits<size_t>::max();
+    multiplication_thresholds thresholds{ never, never, never };
+    set_multiplication_thresholds(thresholds);
+
+    // Every algorithm is compared to the best combination of the previous ones
+    const auto best = [](limbs_span result_, limbs_view lhs_, limbs_view rhs_) { multiply(result_, lhs_, rhs_); };
+
+    thresholds.karatsuba = find_crossover(multiply_karatsuba, best, 8, 512).value_or(previous_thresholds.karatsuba);
+    set_multiplication_thresholds(thresholds);
+
+    thresholds.toom_3 = find_crossover(multiply_toom_3, best, thresholds.karatsuba, 8192).value_or(never);
+    set_multiplication_thresholds(thresholds);
+
+    thresholds.ntt = find_crossover(multiply_ntt, best, (thresholds.toom_3 != never) ? thresholds.toom_3 : thresholds.karatsuba, 1 << 18).value_or(never);
+
+    set_multiplication_thresholds(previous_thresholds);
+    return thresholds;
+}
+
+// ----------------------------------------------------------------------------
+
+void large_unsigned_integer::set_parallel_policy(parallel_policy policy_) {
+    const size_t nb_threads = std::max(policy_.nb_threads, size_t{ 1 });
+    parallel_nb_threads.store(nb_threads, std::memory_order_relaxed);
+    parallel_multiplication_threshold.store(policy_.multiplication_threshold, std::memory_order_relaxed);
+    parallel_linear_threshold.store(policy_.linear_threshold, std::memory_order_relaxed);
+    nb_available_threads.store(nb_threads - 1, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer::parallel_policy large_unsigned_integer::get_parallel_policy() {
+    return {
+        parallel_nb_threads.load(std::memory_order_relaxed),
+        parallel_multiplication_threshold.load(std::memory_order_relaxed),
+        parallel_linear_threshold.load(std::memory_order_relaxed),
+    };
+}
+
+// ----------------------------------------------------------------------------
+
+void large_unsigned_integer::set_simd_kernel(simd_kernel kernel_) {
+    details::kernels::select_kernel(kernel_);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer::simd_kernel large_unsigned_integer::get_simd_kernel() {
+    return details::kernels::get_selected_kernel();
+}
+
+// ----------------------------------------------------------------------------
+
+large_unsigned_integer::large_unsigned_integer() : large_unsigned_integer(0u) {}
+
+// ----------------------------------------------------------------------------
+
+large_unsigned_integer::large_unsigned_integer(collection_type data_)
+    : data(cleanup(std::move(data_))) {}
+
+// ----------------------------------------------------------------------------
+
+large_unsigned_integer::large_unsigned_integer(std::pmr::memory_resource* resource_)
+    : data(resource_) {}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator+(const large_unsigned_integer& other_) const {
+    // Enforce lhs to be larger than rhs
+    if (*this < other_) {
+        return other_ + (*this);
+    }
+
+    return add_large_unsigned_integer_sorted(data, other_.data);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator-(const large_unsigned_integer& other_) const {
+    assert(*this >= other_);    // Enforce a positive result
+
+    if (*this < other_) {
+        return {};
+    }
+
+    return subtract_large_unsigned_integer_sorted(data, other_.data);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator*(const large_unsigned_integer& other_) const {
+    // Squaring has a dedicated and faster path
+    if (this == &other_) {
+        return multiply_large_unsigned_integer_sorted(data, data);
+    }
+
+    // Enforce lhs to be larger than rhs
+    if (*this < other_) {
+        return other_ * (*this);
+    }
+
+    return multiply_large_unsigned_integer_sorted(data, other_.data);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::strong_ordering large_unsigned_integer::operator<=>(const large_unsigned_integer& other_) const {
+    return compare_large_unsigned_integer(data, other_.data);
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] bool large_unsigned_integer::operator==(const large_unsigned_integer& other_) const {
+    return this->data == other_.data;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator+=(const large_unsigned_integer& other_) {
+    add_large_unsigned_integer_in_place(data, other_.data);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator+=(underlying_type value_) {
+    add_large_unsigned_integer_in_place(data, value_);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator-=(const large_unsigned_integer& other_) {
+    assert(*this >= other_);    // Enforce a positive result
+
+    if (*this < other_) {
+        data.clear();
+        return *this;
+    }
+
+    subtract_large_unsigned_integer_in_place(data, other_.data);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator*=(underlying_type factor_) {
+    return mul_add(factor_, 0);
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::mul_add(underlying_type factor_, underlying_type value_) {
+    multiply_add_large_unsigned_integer_in_place(data, factor_, value_);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator/(const large_unsigned_integer& other_) const {
+    return std::move(divide_large_unsigned_integer(data, other_.data).first);
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator%(const large_unsigned_integer& other_) const {
+    return std::move(divide_large_unsigned_integer(data, other_.data).second);
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator/=(const large_unsigned_integer& other_) {
+    data = std::move(divide_large_unsigned_integer(data, other_.data).first);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator%=(const large_unsigned_integer& other_) {
+    data = std::move(divide_large_unsigned_integer(data, other_.data).second);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator/=(underlying_type divisor_) {
+    if (divisor_ == 0) {
+        throw std::domain_error("Division by zero");
+    }
+
+    std::ignore = divide_large_unsigned_integer_by_limb_in_place(data, divisor_);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer::underlying_type large_unsigned_integer::operator%(underlying_type divisor_) const {
+    if (divisor_ == 0) {
+        throw std::domain_error("Division by zero");
+    }
+
+    // Only the remainder is needed, Horner's scheme from the most significant limb
+    extended_type remainder{ 0 };
+    for (auto limb : data | std::views::reverse) {
+        remainder = ((remainder << nb_extended_type_bits) | limb) % divisor_;
+    }
+    return static_cast<underlying_type>(remainder);
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator<<(size_t nb_bits_) const {
+    large_unsigned_integer result = *this;
+    result <<= nb_bits_;
+    return result;
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer large_unsigned_integer::operator>>(size_t nb_bits_) const {
+    large_unsigned_integer result = *this;
+    result >>= nb_bits_;
+    return result;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator<<=(size_t nb_bits_) {
+    shift_left_large_unsigned_integer_in_place(data, nb_bits_);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+large_unsigned_integer& large_unsigned_integer::operator>>=(size_t nb_bits_) {
+    shift_right_large_unsigned_integer_in_place(data, nb_bits_);
+    return *this;
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] size_t large_unsigned_integer::bit_width() const {
+    if (data.empty()) {
+        return 0;
+    }
+
+    return (data.size() - 1) * nb_extended_type_bits + std::bit_width(data.back());
+}
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] const large_unsigned_integer::collection_type& large_unsigned_integer::get_data() const {
+    return data;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::pmr::memory_resource* large_unsigned_integer::get_resource() const {
+    return data.get_resource();
+}
+
+// ----------------------------------------------------------------------------
+
+namespace details {
+
+using underlying_type = large_unsigned_integer::underlying_type;
+
+// ----------------------------------------------------------------------------
+// Value of a large unsigned integer that fits in 64 bits
+[[nodiscard]] std::uint64_t to_uint64(const large_unsigned_integer& value_) {
+    assert(value_.bit_width() <= 64);
+
+    std::uint64_t result = 0;
+    for (auto limb : value_.get_data() | std::views::reverse) {
+        result = (nb_extended_type_bits < 64) ? (result << (nb_extended_type_bits % 64)) | limb : limb;
+    }
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// floor(2^(2s) / divisor_) with s the bit width of the divisor, computed with a
+// precision-doubling Newton iteration x = x + x * (2^(2p) - d * x) / 2^(2p)
+[[nodiscard]] large_unsigned_integer compute_reciprocal(const large_unsigned_integer& divisor_) {
+    assert(divisor_ != 0u);
+    using wide_type = unsigned __int128;
+
+    const size_t width = divisor_.bit_width();
+
+    // Seed from the leading bits with an exact 128-bit division
+    constexpr const size_t seed_precision = 50;
+    size_t precision = std::min(width, seed_precision);
+    const wide_type seed = (wide_type{ 1 } << (2 * precision)) / to_uint64(divisor_ >> (width - precision));
+    large_unsigned_integer result(static_cast<std::uint64_t>(seed));
+
+    while (precision < width) {
+        const size_t next_precision = std::min(2 * precision, width);
+        result <<= next_precision - precision;
+        precision = next_precision;
+
+        const auto truncated_divisor = divisor_ >> (width - precision);
+        const auto one = large_unsigned_integer(1u) << (2 * precision);
+        const auto product = truncated_divisor * result;
+        if (product <= one) {
+            result += (result * (one - product)) >> (2 * precision);
+        } else {
+            result -= (result * (product - one)) >> (2 * precision);
+        }
+    }
+
+    // Fix the last units
+    const auto one = large_unsigned_integer(1u) << (2 * width);
+    auto product = divisor_ * result;
+    while (product > one) {
+        product -= divisor_;
+        result -= large_unsigned_integer(1u);
+    }
+
+    while (true) {
+        auto next_product = product + divisor_;
+        if (next_product > one) {
+            break;
+        }
+        product = std::move(next_product);
+        result += 1u;
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+// 10^(19 * 2^level) and what is needed to divide by it with Barrett's method
+struct power_of_ten {
+    large_unsigned_integer value;
+    large_unsigned_integer reciprocal;  // floor(2^(2 * width) / value)
+    size_t width;                       // Number of bits of value
+    size_t nb_digits;
+};
+
+// Largest number of decimal digits that always fits in 64 bits
+constexpr const size_t nb_leaf_digits = std::numeric_limits<std::uint64_t>::digits10;
+
+// ----------------------------------------------------------------------------
+// Cached powers of ten, the references stay valid as the cache only grows
+[[nodiscard]] const power_of_ten& get_power_of_ten(size_t level_) {
+    static std::mutex mutex;
+    static std::deque<power_of_ten> powers;
+
+    std::scoped_lock lock(mutex);
+    while (powers.size() <= level_) {
+        auto value = powers.empty()
+            ? large_unsigned_integer(10000000000000000000ULL)
+            : powers.back().value * powers.back().value;
+        const size_t nb_digits = powers.empty() ? nb_leaf_digits : 2 * powers.back().nb_digits;
+
+        auto reciprocal = compute_reciprocal(value);
+        const size_t width = value.bit_width();
+        powers.emplace_back(std::move(value), std::move(reciprocal), width, nb_digits);
+    }
+
+    return powers[level_];
+}
+
+// ----------------------------------------------------------------------------
+// Quotient and remainder of value_ by power_.value using Barrett's method (value_ < power_.value^2)
+[[nodiscard]] std::tuple<large_unsigned_integer, large_unsigned_integer> divide_by_power_of_ten(const large_unsigned_integer& value_, const power_of_ten& power_) {
+    // The estimate is never larger than the quotient and at most 2 units smaller
+    auto quotient = ((value_ >> (power_.width - 1)) * power_.reciprocal) >> (power_.width + 1);
+    auto remainder = value_ - quotient * power_.value;
+    while (remainder >= power_.value) {
+        remainder -= power_.value;
+        quotient += 1u;
+    }
+
+    return { std::move(quotient), std::move(remainder) };
+}
+
+// ----------------------------------------------------------------------------
+// Write value_ (< 10^19) at the end of buffer_, left padded to width_
+void write_leaf(std::string& buffer_, std::uint64_t value_, size_t width_) {
+    std::array<char, nb_leaf_digits + 1> digits;
+    const auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value_);
+    assert(error == std::errc{});
+
+    const auto nb_digits = static_cast<size_t>(end - digits.data());
+    if (nb_digits < width_) {
+        buffer_.append(width_ - nb_digits, '0');
+    }
+    buffer_.append(digits.data(), end);
+}
+
+// ----------------------------------------------------------------------------
+// Recursively split value_ (< 10^(19 * 2^(level + 1))) by cached powers of ten, when
+// padded_ all the 19 * 2^(level + 1) digits are written
+void write_base_10(std::string& buffer_, const large_unsigned_integer& value_, size_t level_, bool padded_) {
+    const auto& power = get_power_of_ten(level_);
+    const auto [quotient, remainder] = divide_by_power_of_ten(value_, power);
+
+    const auto write_part = [&buffer_, level_](const large_unsigned_integer& part_, bool padded_part_) {
+        if (level_ == 0) {
+            write_leaf(buffer_, to_uint64(part_), padded_part_ ? nb_leaf_digits : 0);
+        } else {
+            write_base_10(buffer_, part_, level_ - 1, padded_part_);
+        }
+    };
+
+    // Leading zeros are only written in padded parts
+    if (padded_ || quotient != 0u) {
+        write_part(quotient, padded_);
+        write_part(remainder, true);
+    } else {
+        write_part(remainder, false);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] bool is_number_well_formed(std::string_view str_) {
+    return std::ranges::all_of(str_, [](auto digit) {
+        return std::isdigit(static_cast<unsigned char>(digit)) != 0;
+    });
+}
+
+} // namespace details
+
+// ----------------------------------------------------------------------------
+// Divide and conquer parsing, the string is read by chunks of 19 digits with
+// std::from_chars and the chunks are combined pairwise with the cached powers
+// 10^(19 * 2^k), from the least significant to the most significant ones
+[[nodiscard]] std::optional<large_unsigned_integer> large_unsigned_integer::from_string(std::string_view str_) {
+    assert(!str_.empty());
+    if (str_.empty()) {
+        return {};
+    }
+
+    const bool well_formed = details::is_number_well_formed(str_);
+
+    assert(well_formed);
+    if (!well_formed) {
+        return {};
+    }
+
+    // Chunks from the least significant one, only the last one can be shorter
+    std::vector<large_unsigned_integer> parts;
+    parts.reserve(str_.size() / details::nb_leaf_digits + 1);
+    for (size_t end = str_.size(); end > 0;) {
+        const size_t begin = end > details::nb_leaf_digits ? end - details::nb_leaf_digits : 0;
+
+        std::uint64_t chunk = 0;
+        [[maybe_unused]] const auto [ptr, error] = std::from_chars(str_.data() + begin, str_.data() + end, chunk);
+        assert(error == std::errc{} && ptr == str_.data() + end);
+
+        parts.emplace_back(chunk);
+        end = begin;
+    }
+
+    // Combine pairs: parts[2i + 1] * 10^(19 * 2^level) + parts[2i]
+    for (size_t level = 0; parts.size() > 1; ++level) {
+        const auto& power = details::get_power_of_ten(level);
+
+        const size_t nb_pairs = parts.size() / 2;
+        for (size_t index = 0; index < nb_pairs; ++index) {
+            auto value = parts[2 * index + 1] * power.value;
+            value += parts[2 * index];
+            parts[index] = std::move(value);
+        }
+
+        // An odd part is carried to the next level
+        if (parts.size() % 2 == 1) {
+            parts[nb_pairs] = std::move(parts.back());
+        }
+        parts.resize((parts.size() + 1) / 2);
+    }
+
+    return std::make_optional<large_unsigned_integer>(std::move(parts.front()));
+}
+
+// ----------------------------------------------------------------------------
+// Divide and conquer conversion, the number is split by the cached powers
+// 10^(19 * 2^k) and the leaves are converted with std::to_chars
+[[nodiscard]] std::string to_string(const large_unsigned_integer& value_) {
+    if (value_.bit_width() <= 64) {
+        std::string result;
+        details::write_leaf(result, details::to_uint64(value_), 0);
+        return result;
+    }
+
+    // Find the level that splits the number in 2 halves, value < 2^(2 * (width - 1)) <= power^2
+    size_t level = 0;
+    while (2 * (details::get_power_of_ten(level).width - 1) < value_.bit_width()) {
+        ++level;
+    }
+
+    std::string result;
+    result.reserve(2 * details::get_power_of_ten(level).nb_digits);
+    details::write_base_10(result, value_, level, false);
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::pair<large_unsigned_integer, large_unsigned_integer> divmod(const large_unsigned_integer& dividend_, const large_unsigned_integer& divisor_) {
+    auto [quotient, remainder] = divide_large_unsigned_integer(dividend_.get_data(), divisor_.get_data());
+    return { large_unsigned_integer(std::move(quotient)), large_unsigned_integer(std::move(remainder)) };
+}
+
+// ----------------------------------------------------------------------------
+// Precision-doubling Newton iteration on the reciprocal square root, so that no
+// division is involved and the cost is a few multiplications of the final size
+[[nodiscard]] large_unsigned_integer isqrt(const large_unsigned_integer& value_) {
+    if (value_ == 0u) {
+        return {};
+    }
+
+    // value = m * 4^half_width with m in [1/4, 1)
+    const size_t half_width = (value_.bit_width() + 1) / 2;
+
+    // Seed y = 2^precision / sqrt(m) from the leading bits in double precision
+    constexpr const size_t seed_precision = 50;
+    const large_unsigned_integer leading = scale(value_, 63, 2 * half_width);
+    double m = 0.0;
+    for (auto limb : leading.get_data() | std::views::reverse) {
+        m = std::ldexp(m, large_unsigned_integer::nb_extended_type_bits) + static_cast<double>(limb);
+    }
+    m = std::ldexp(m, -63);
+
+    large_unsigned_integer y(static_cast<std::uint64_t>(std::ldexp(1.0 / std::sqrt(m), seed_precision)));
+    size_t precision = seed_precision;
+
+    // Every iteration y = y * (3 - m * y^2) / 2 doubles the number of correct bits
+    constexpr const size_t guard_bits = 16;
+    const size_t target_precision = half_width + guard_bits;
+    while (precision < target_precision) {
+        const size_t next_precision = std::min(2 * precision, target_precision);
+        y <<= next_precision - precision;
+        precision = next_precision;
+
+        // m * y^2 ~ 2^(3 * precision)
+        const auto m_y2 = scale(value_, precision, 2 * half_width) * (y * y);
+        const auto three = large_unsigned_integer(3u) << (3 * precision);
+        y = (y * (three - m_y2)) >> (3 * precision + 1);
+    }
+
+    // sqrt(value) = value / sqrt(value) = value * y / 2^(precision + half_width)
+    auto result = (value_ * y) >> (precision + half_width);
+
+    // Fix the last unit, (s + 1)^2 = s^2 + 2s + 1
+    auto square = result * result;
+    while (square > value_) {
+        square -= result + result;
+        square += 1u;
+        result -= large_unsigned_integer(1u);
+    }
+
+    while (true) {
+        auto next_square = square + result + result;
+        next_square += 1u;
+        if (next_square > value_) {
+            break;
+        }
+
+        square = std::move(next_square);
+        result += 1u;
+    }
+
+    return result;
 }
 
 // ----------------------------------------------------------------------------
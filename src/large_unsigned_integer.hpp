@@ -1,34 +1,102 @@
 #ifndef LARGE_UNSIGNED_INTEGER_HPP
 #define LARGE_UNSIGNED_INTEGER_HPP
 
+#include <compare>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "small_vector.hpp"
+
 
 // ----------------------------------------------------------------------------
 // Large integer to handle infinitely large integer number
 class large_unsigned_integer {
 public:
+#if defined(LARGE_UNSIGNED_INTEGER_64_BIT_LIMBS)
+    using underlying_type = std::uint64_t;
+    using extended_type = unsigned __int128;
+    using signed_extended_type = __int128;
+#else
     using underlying_type = std::uint32_t;
     using extended_type = std::uint64_t;
     using signed_extended_type = std::int64_t;
+#endif
 
-    using collection_type = std::vector<underlying_type>;
+    // Limbs are stored in place up to nb_inline_limbs (256 bits), so that scalars and
+    // small operands never allocate
+    static constexpr const size_t nb_inline_limbs = 32 / sizeof(underlying_type);
+    using collection_type = small_vector<underlying_type, nb_inline_limbs>;
 
     static constexpr const auto nb_extended_type_bits = sizeof(underlying_type) * 8;
     static constexpr const extended_type base = extended_type{ 1 } << nb_extended_type_bits;
 
-    // Factory method to create a large integer from string
-    [[nodiscard]] static std::optional<large_unsigned_integer> from_string(const std::string& str_);
+    // Policy applied when an operation leaves unused capacity behind
+    enum class storage_policy {
+        keep_capacity,  // Reuse the capacity in later operations (default)
+        shrink_to_fit,  // Free unused capacity after every operation
+    };
+
+    static void set_storage_policy(storage_policy policy_);
+    [[nodiscard]] static storage_policy get_storage_policy();
+
+    // Size of the smallest operand, in limbs, from which each multiplication algorithm is used
+    struct multiplication_thresholds {
+        size_t karatsuba = 40;
+        size_t toom_3 = 256;
+        size_t ntt = 131072;
+    };
+
+    static void set_multiplication_thresholds(multiplication_thresholds thresholds_);
+    [[nodiscard]] static multiplication_thresholds get_multiplication_thresholds();
+
+    // Measure the crossover points of the multiplication algorithms on the current machine,
+    // the result can be given to set_multiplication_thresholds
+    [[nodiscard]] static multiplication_thresholds benchmark_multiplication_thresholds();
+
+    // Parallel execution of the operations on huge operands, the work is split as
+    // soon as the smallest operand reaches the threshold of the operation (in limbs)
+    struct parallel_policy {
+        size_t nb_threads = 1;                  // Including the calling thread, 1 keeps everything serial
+        size_t multiplication_threshold = 16384;
+        size_t linear_threshold = 1 << 20;      // Add and subtract
+    };
+
+    // Should not be changed while operations are running
+    static void set_parallel_policy(parallel_policy policy_);
+    [[nodiscard]] static parallel_policy get_parallel_policy();
+
+    // Instruction set of the linear kernels (add, subtract, compare and multiplication by a limb),
+    // the best one supported by the processor is selected at startup
+    enum class simd_kernel {
+        scalar,
+        avx2,
+        avx512,
+    };
+
+    // A kernel that is not supported falls back to the best supported one below it
+    static void set_simd_kernel(simd_kernel kernel_);
+    [[nodiscard]] static simd_kernel get_simd_kernel();
+
+    // Factory method to create a large integer from a string of decimal digits
+    [[nodiscard]] static std::optional<large_unsigned_integer> from_string(std::string_view str_);
 
     // Constructors
     large_unsigned_integer();
     large_unsigned_integer(std::unsigned_integral auto value_);
-    large_unsigned_integer(std::vector<underlying_type> data_);
+    large_unsigned_integer(collection_type data_);
+
+    // Null value whose limbs beyond the inline ones are allocated from resource_, the
+    // resource is kept by assignments so buffers updated in place stay in it
+    explicit large_unsigned_integer(std::pmr::memory_resource* resource_);
 
     // Operators
     [[nodiscard]] large_unsigned_integer operator+(const large_unsigned_integer& other_) const;
@@ -37,7 +105,36 @@ public:
     [[nodiscard]] std::strong_ordering operator<=>(const large_unsigned_integer& other_) const;
     [[nodiscard]] bool operator==(const large_unsigned_integer& other_) const;
 
+    // In place operators, they reuse the current storage whenever possible
+    large_unsigned_integer& operator+=(const large_unsigned_integer& other_);
+    large_unsigned_integer& operator+=(underlying_type value_);
+    large_unsigned_integer& operator-=(const large_unsigned_integer& other_);
+    large_unsigned_integer& operator*=(underlying_type factor_);
+
+    // Fused multiply-add: *this = *this * factor_ + value_
+    large_unsigned_integer& mul_add(underlying_type factor_, underlying_type value_);
+
+    // Division, throw std::domain_error when dividing by 0
+    [[nodiscard]] large_unsigned_integer operator/(const large_unsigned_integer& other_) const;
+    [[nodiscard]] large_unsigned_integer operator%(const large_unsigned_integer& other_) const;
+    large_unsigned_integer& operator/=(const large_unsigned_integer& other_);
+    large_unsigned_integer& operator%=(const large_unsigned_integer& other_);
+
+    // Division by a single limb, without any allocation
+    large_unsigned_integer& operator/=(underlying_type divisor_);
+    [[nodiscard]] underlying_type operator%(underlying_type divisor_) const;
+
+    // Bit shifts
+    [[nodiscard]] large_unsigned_integer operator<<(size_t nb_bits_) const;
+    [[nodiscard]] large_unsigned_integer operator>>(size_t nb_bits_) const;
+    large_unsigned_integer& operator<<=(size_t nb_bits_);
+    large_unsigned_integer& operator>>=(size_t nb_bits_);
+
+    // Number of bits needed to represent the value (0 for 0)
+    [[nodiscard]] size_t bit_width() const;
+
     [[nodiscard]] const collection_type& get_data() const;
+    [[nodiscard]] std::pmr::memory_resource* get_resource() const;
 
 private:
     // Convert an integral value to raw data
@@ -56,7 +153,7 @@ large_unsigned_integer::large_unsigned_integer(std::unsigned_integral auto value
 // ------------------------------------------------------------------------
 
 [[nodiscard]] large_unsigned_integer::collection_type large_unsigned_integer::to_data_collection(std::unsigned_integral auto value_) {
-    std::vector<underlying_type> data;
+    collection_type data;
 
     if constexpr (sizeof(decltype(value_)) > sizeof(underlying_type)) {
         while (value_ > std::numeric_limits<underlying_type>::max()) {
@@ -77,6 +174,12 @@ large_unsigned_integer::large_unsigned_integer(std::unsigned_integral auto value
 
 [[nodiscard]] std::string to_string(const large_unsigned_integer& value_);
 
+// Quotient and remainder at once, throw std::domain_error when dividing by 0
+[[nodiscard]] std::pair<large_unsigned_integer, large_unsigned_integer> divmod(const large_unsigned_integer& dividend_, const large_unsigned_integer& divisor_);
+
+// Integer square root, floor(sqrt(value_))
+[[nodiscard]] large_unsigned_integer isqrt(const large_unsigned_integer& value_);
+
 std::istream& operator>>(std::istream& stream_, large_unsigned_integer& value_);
 std::ostream& operator<<(std::ostream& stream_, const large_unsigned_integer& value_);
 
@@ -0,0 +1,438 @@
+#include "large_unsigned_integer_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define LARGE_UNSIGNED_INTEGER_HAS_SIMD_KERNELS
+#define LARGE_UNSIGNED_INTEGER_TARGET_AVX2 __attribute__((target("avx2")))
+#define LARGE_UNSIGNED_INTEGER_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+
+namespace details::kernels {
+
+namespace {
+
+using simd_kernel = large_unsigned_integer::simd_kernel;
+
+// ------------------------------------------------------------------------
+// Scalar kernels, used for the tails of the vectorized ones and as the fallback
+
+bool add_scalar(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool carry_) {
+    for (size_t index = 0; index < size_; ++index) {
+        result_[index] = add_with_carry(lhs_[index], rhs_[index], carry_);
+    }
+    return carry_;
+}
+
+bool subtract_scalar(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool borrow_) {
+    for (size_t index = 0; index < size_; ++index) {
+        result_[index] = subtract_with_borrow(lhs_[index], rhs_[index], borrow_);
+    }
+    return borrow_;
+}
+
+std::strong_ordering compare_scalar(const underlying_type* lhs_, const underlying_type* rhs_, size_t size_) {
+    for (size_t index = size_; index > 0; --index) {
+        if (lhs_[index - 1] != rhs_[index - 1]) {
+            return lhs_[index - 1] <=> rhs_[index - 1];
+        }
+    }
+    return std::strong_ordering::equal;
+}
+
+underlying_type multiply_add_scalar(underlying_type* result_, const underlying_type* lhs_, size_t size_, underlying_type factor_, underlying_type carry_) {
+    for (size_t index = 0; index < size_; ++index) {
+        result_[index] = multiply_add(lhs_[index], factor_, 0, carry_);
+    }
+    return carry_;
+}
+
+constexpr const kernel_table scalar_kernels{ add_scalar, subtract_scalar, compare_scalar, multiply_add_scalar };
+
+#if defined(LARGE_UNSIGNED_INTEGER_HAS_SIMD_KERNELS)
+
+// ------------------------------------------------------------------------
+// The vectorized add and subtract compute every lane independently, then resolve
+// the carries between the lanes of a vector at once: a carry enters a lane when
+// the lane below generates one, or propagates the one it receives (lane all ones
+// for an addition, lane null for a subtraction). Adding the propagate mask to the
+// shifted generate mask ripples the carries like a regular binary addition.
+// Return the mask of the lanes receiving a carry, carry_ becomes the carry out
+[[nodiscard]] inline unsigned int resolve_carries(unsigned int generate_, unsigned int propagate_, bool& carry_, unsigned int nb_lanes_) {
+    const unsigned int sum = ((generate_ << 1) | static_cast<unsigned int>(carry_)) + propagate_;
+    carry_ = ((sum >> nb_lanes_) & 1) != 0;
+    return (sum ^ propagate_) & ((1u << nb_lanes_) - 1);
+}
+
+// ------------------------------------------------------------------------
+// AVX2 kernels, 256-bit vectors
+
+constexpr const size_t nb_avx2_lanes = 32 / sizeof(underlying_type);
+
+// Mask of the lanes of value_ with their sign bit set
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 [[nodiscard]] inline unsigned int avx2_lanes_mask(__m256i value_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(value_)));
+    } else {
+        return static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(value_)));
+    }
+}
+
+// All ones in the lanes whose bit is set in mask_
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 [[nodiscard]] inline __m256i avx2_expand_mask(unsigned int mask_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(mask_)), bits), bits);
+    } else {
+        const __m256i bits = _mm256_setr_epi64x(1, 2, 4, 8);
+        return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(mask_), bits), bits);
+    }
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 [[nodiscard]] inline __m256i avx2_add(__m256i lhs_, __m256i rhs_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        return _mm256_add_epi32(lhs_, rhs_);
+    } else {
+        return _mm256_add_epi64(lhs_, rhs_);
+    }
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 [[nodiscard]] inline __m256i avx2_subtract(__m256i lhs_, __m256i rhs_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        return _mm256_sub_epi32(lhs_, rhs_);
+    } else {
+        return _mm256_sub_epi64(lhs_, rhs_);
+    }
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 [[nodiscard]] inline __m256i avx2_equal(__m256i lhs_, __m256i rhs_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        return _mm256_cmpeq_epi32(lhs_, rhs_);
+    } else {
+        return _mm256_cmpeq_epi64(lhs_, rhs_);
+    }
+}
+
+// Unsigned lhs_ > rhs_, AVX2 only has signed comparisons so the sign bits are flipped
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 [[nodiscard]] inline __m256i avx2_greater(__m256i lhs_, __m256i rhs_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+        return _mm256_cmpgt_epi32(_mm256_xor_si256(lhs_, sign), _mm256_xor_si256(rhs_, sign));
+    } else {
+        const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(lhs_, sign), _mm256_xor_si256(rhs_, sign));
+    }
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 bool add_avx2(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool carry_) {
+    const __m256i all_ones = _mm256_set1_epi32(-1);
+
+    size_t index = 0;
+    for (; index + nb_avx2_lanes <= size_; index += nb_avx2_lanes) {
+        const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs_ + index));
+        const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs_ + index));
+        const __m256i sum = avx2_add(lhs, rhs);
+
+        const unsigned int generate = avx2_lanes_mask(avx2_greater(lhs, sum));
+        const unsigned int propagate = avx2_lanes_mask(avx2_equal(sum, all_ones));
+        const unsigned int carries = resolve_carries(generate, propagate, carry_, nb_avx2_lanes);
+
+        // Subtracting all ones adds the carries
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result_ + index), avx2_subtract(sum, avx2_expand_mask(carries)));
+    }
+
+    return add_scalar(result_ + index, lhs_ + index, rhs_ + index, size_ - index, carry_);
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 bool subtract_avx2(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool borrow_) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t index = 0;
+    for (; index + nb_avx2_lanes <= size_; index += nb_avx2_lanes) {
+        const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs_ + index));
+        const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs_ + index));
+        const __m256i difference = avx2_subtract(lhs, rhs);
+
+        const unsigned int generate = avx2_lanes_mask(avx2_greater(rhs, lhs));
+        const unsigned int propagate = avx2_lanes_mask(avx2_equal(difference, zero));
+        const unsigned int borrows = resolve_carries(generate, propagate, borrow_, nb_avx2_lanes);
+
+        // Adding all ones subtracts the borrows
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result_ + index), avx2_add(difference, avx2_expand_mask(borrows)));
+    }
+
+    return subtract_scalar(result_ + index, lhs_ + index, rhs_ + index, size_ - index, borrow_);
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 std::strong_ordering compare_avx2(const underlying_type* lhs_, const underlying_type* rhs_, size_t size_) {
+    constexpr const unsigned int all_lanes = (1u << nb_avx2_lanes) - 1;
+
+    // From the most significant limbs, look for the first vector that differs
+    size_t index = size_;
+    for (; index >= nb_avx2_lanes; index -= nb_avx2_lanes) {
+        const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs_ + index - nb_avx2_lanes));
+        const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs_ + index - nb_avx2_lanes));
+
+        const unsigned int different = ~avx2_lanes_mask(avx2_equal(lhs, rhs)) & all_lanes;
+        if (different != 0) {
+            const size_t lane = index - nb_avx2_lanes + static_cast<size_t>(std::bit_width(different) - 1);
+            return lhs_[lane] <=> rhs_[lane];
+        }
+    }
+
+    return compare_scalar(lhs_, rhs_, index);
+}
+
+// The products of a vector are split in their low and high limbs, the high limbs are
+// shifted by one lane and added to the low ones with the same carry resolution as add
+LARGE_UNSIGNED_INTEGER_TARGET_AVX2 underlying_type multiply_add_avx2(underlying_type* result_, const underlying_type* lhs_, size_t size_, underlying_type factor_, underlying_type carry_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        const __m256i factor = _mm256_set1_epi64x(factor_);
+        const __m256i all_ones = _mm256_set1_epi32(-1);
+        const __m256i previous_lane = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+
+        size_t index = 0;
+        for (; index + nb_avx2_lanes <= size_; index += nb_avx2_lanes) {
+            const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs_ + index));
+            const __m256i even_products = _mm256_mul_epu32(lhs, factor);
+            const __m256i odd_products = _mm256_mul_epu32(_mm256_srli_epi64(lhs, 32), factor);
+
+            const __m256i low = _mm256_blend_epi32(even_products, _mm256_slli_epi64(odd_products, 32), 0b10101010);
+            const __m256i high = _mm256_blend_epi32(_mm256_srli_epi64(even_products, 32), odd_products, 0b10101010);
+
+            // The high limb of a lane goes into the next one, the incoming carry into the first one
+            const __m256i shifted_high = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(high, previous_lane), _mm256_set1_epi32(static_cast<int>(carry_)), 0b00000001);
+            const __m256i sum = _mm256_add_epi32(low, shifted_high);
+
+            bool carry = false;
+            const unsigned int generate = avx2_lanes_mask(avx2_greater(low, sum));
+            const unsigned int propagate = avx2_lanes_mask(_mm256_cmpeq_epi32(sum, all_ones));
+            const unsigned int carries = resolve_carries(generate, propagate, carry, nb_avx2_lanes);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(result_ + index), _mm256_sub_epi32(sum, avx2_expand_mask(carries)));
+
+            // The high limb is at most factor - 1 so adding the carry cannot overflow
+            carry_ = static_cast<underlying_type>(_mm256_extract_epi32(high, 7)) + carry;
+        }
+
+        return multiply_add_scalar(result_ + index, lhs_ + index, size_ - index, factor_, carry_);
+    } else {
+        // No 64-bit x 64-bit vector product, mulx is faster
+        return multiply_add_scalar(result_, lhs_, size_, factor_, carry_);
+    }
+}
+
+constexpr const kernel_table avx2_kernels{ add_avx2, subtract_avx2, compare_avx2, multiply_add_avx2 };
+
+// ------------------------------------------------------------------------
+// AVX-512 kernels, 512-bit vectors with native unsigned comparisons into masks
+
+constexpr const size_t nb_avx512_lanes = 64 / sizeof(underlying_type);
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX512 bool add_avx512(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool carry_) {
+    const __m512i all_ones = _mm512_set1_epi32(-1);
+
+    size_t index = 0;
+    for (; index + nb_avx512_lanes <= size_; index += nb_avx512_lanes) {
+        const __m512i lhs = _mm512_loadu_si512(lhs_ + index);
+        const __m512i rhs = _mm512_loadu_si512(rhs_ + index);
+
+        if constexpr (sizeof(underlying_type) == 4) {
+            const __m512i sum = _mm512_add_epi32(lhs, rhs);
+            const unsigned int generate = _mm512_cmplt_epu32_mask(sum, lhs);
+            const unsigned int propagate = _mm512_cmpeq_epi32_mask(sum, all_ones);
+            const auto carries = static_cast<__mmask16>(resolve_carries(generate, propagate, carry_, nb_avx512_lanes));
+            _mm512_storeu_si512(result_ + index, _mm512_mask_sub_epi32(sum, carries, sum, all_ones));
+        } else {
+            const __m512i sum = _mm512_add_epi64(lhs, rhs);
+            const unsigned int generate = _mm512_cmplt_epu64_mask(sum, lhs);
+            const unsigned int propagate = _mm512_cmpeq_epi64_mask(sum, all_ones);
+            const auto carries = static_cast<__mmask8>(resolve_carries(generate, propagate, carry_, nb_avx512_lanes));
+            _mm512_storeu_si512(result_ + index, _mm512_mask_sub_epi64(sum, carries, sum, all_ones));
+        }
+    }
+
+    return add_scalar(result_ + index, lhs_ + index, rhs_ + index, size_ - index, carry_);
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX512 bool subtract_avx512(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool borrow_) {
+    const __m512i all_ones = _mm512_set1_epi32(-1);
+    const __m512i zero = _mm512_setzero_si512();
+
+    size_t index = 0;
+    for (; index + nb_avx512_lanes <= size_; index += nb_avx512_lanes) {
+        const __m512i lhs = _mm512_loadu_si512(lhs_ + index);
+        const __m512i rhs = _mm512_loadu_si512(rhs_ + index);
+
+        if constexpr (sizeof(underlying_type) == 4) {
+            const __m512i difference = _mm512_sub_epi32(lhs, rhs);
+            const unsigned int generate = _mm512_cmplt_epu32_mask(lhs, rhs);
+            const unsigned int propagate = _mm512_cmpeq_epi32_mask(difference, zero);
+            const auto borrows = static_cast<__mmask16>(resolve_carries(generate, propagate, borrow_, nb_avx512_lanes));
+            _mm512_storeu_si512(result_ + index, _mm512_mask_add_epi32(difference, borrows, difference, all_ones));
+        } else {
+            const __m512i difference = _mm512_sub_epi64(lhs, rhs);
+            const unsigned int generate = _mm512_cmplt_epu64_mask(lhs, rhs);
+            const unsigned int propagate = _mm512_cmpeq_epi64_mask(difference, zero);
+            const auto borrows = static_cast<__mmask8>(resolve_carries(generate, propagate, borrow_, nb_avx512_lanes));
+            _mm512_storeu_si512(result_ + index, _mm512_mask_add_epi64(difference, borrows, difference, all_ones));
+        }
+    }
+
+    return subtract_scalar(result_ + index, lhs_ + index, rhs_ + index, size_ - index, borrow_);
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX512 std::strong_ordering compare_avx512(const underlying_type* lhs_, const underlying_type* rhs_, size_t size_) {
+    size_t index = size_;
+    for (; index >= nb_avx512_lanes; index -= nb_avx512_lanes) {
+        const __m512i lhs = _mm512_loadu_si512(lhs_ + index - nb_avx512_lanes);
+        const __m512i rhs = _mm512_loadu_si512(rhs_ + index - nb_avx512_lanes);
+
+        unsigned int different = 0;
+        if constexpr (sizeof(underlying_type) == 4) {
+            different = _mm512_cmpneq_epi32_mask(lhs, rhs);
+        } else {
+            different = _mm512_cmpneq_epi64_mask(lhs, rhs);
+        }
+
+        if (different != 0) {
+            const size_t lane = index - nb_avx512_lanes + static_cast<size_t>(std::bit_width(different) - 1);
+            return lhs_[lane] <=> rhs_[lane];
+        }
+    }
+
+    return compare_scalar(lhs_, rhs_, index);
+}
+
+LARGE_UNSIGNED_INTEGER_TARGET_AVX512 underlying_type multiply_add_avx512(underlying_type* result_, const underlying_type* lhs_, size_t size_, underlying_type factor_, underlying_type carry_) {
+    if constexpr (sizeof(underlying_type) == 4) {
+        const __m512i factor = _mm512_set1_epi64(factor_);
+        const __m512i all_ones = _mm512_set1_epi32(-1);
+        const __m512i previous_lane = _mm512_setr_epi32(15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14);
+        constexpr const __mmask16 odd_lanes = 0xAAAA;
+
+        size_t index = 0;
+        for (; index + nb_avx512_lanes <= size_; index += nb_avx512_lanes) {
+            const __m512i lhs = _mm512_loadu_si512(lhs_ + index);
+            const __m512i even_products = _mm512_mul_epu32(lhs, factor);
+            const __m512i odd_products = _mm512_mul_epu32(_mm512_srli_epi64(lhs, 32), factor);
+
+            const __m512i low = _mm512_mask_blend_epi32(odd_lanes, even_products, _mm512_slli_epi64(odd_products, 32));
+            const __m512i high = _mm512_mask_blend_epi32(odd_lanes, _mm512_srli_epi64(even_products, 32), odd_products);
+
+            const __m512i shifted_high = _mm512_mask_set1_epi32(_mm512_permutexvar_epi32(previous_lane, high), 1, static_cast<int>(carry_));
+            const __m512i sum = _mm512_add_epi32(low, shifted_high);
+
+            bool carry = false;
+            const unsigned int generate = _mm512_cmplt_epu32_mask(sum, low);
+            const unsigned int propagate = _mm512_cmpeq_epi32_mask(sum, all_ones);
+            const auto carries = static_cast<__mmask16>(resolve_carries(generate, propagate, carry, nb_avx512_lanes));
+            _mm512_storeu_si512(result_ + index, _mm512_mask_sub_epi32(sum, carries, sum, all_ones));
+
+            const __m128i upper_high = _mm512_extracti32x4_epi32(high, 3);
+            carry_ = static_cast<underlying_type>(_mm_extract_epi32(upper_high, 3)) + carry;
+        }
+
+        return multiply_add_scalar(result_ + index, lhs_ + index, size_ - index, factor_, carry_);
+    } else {
+        return multiply_add_scalar(result_, lhs_, size_, factor_, carry_);
+    }
+}
+
+constexpr const kernel_table avx512_kernels{ add_avx512, subtract_avx512, compare_avx512, multiply_add_avx512 };
+
+#endif
+
+// ------------------------------------------------------------------------
+
+[[nodiscard]] bool is_supported(simd_kernel kernel_) {
+    switch (kernel_) {
+    case simd_kernel::scalar:
+        return true;
+#if defined(LARGE_UNSIGNED_INTEGER_HAS_SIMD_KERNELS)
+    case simd_kernel::avx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    case simd_kernel::avx512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+[[nodiscard]] std::atomic<const kernel_table*>& selected_kernels() {
+    static std::atomic<const kernel_table*> kernels{ &get_kernel_table(get_best_kernel()) };
+    return kernels;
+}
+
+[[nodiscard]] std::atomic<simd_kernel>& selected_kernel() {
+    static std::atomic<simd_kernel> kernel{ get_best_kernel() };
+    return kernel;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] const kernel_table& get_kernel_table(simd_kernel kernel_) {
+    assert(is_supported(kernel_));
+
+    switch (kernel_) {
+#if defined(LARGE_UNSIGNED_INTEGER_HAS_SIMD_KERNELS)
+    case simd_kernel::avx2:
+        return avx2_kernels;
+    case simd_kernel::avx512:
+        return avx512_kernels;
+#endif
+    default:
+        return scalar_kernels;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] simd_kernel get_best_kernel() {
+    static const simd_kernel best = [] {
+        for (auto kernel : { simd_kernel::avx512, simd_kernel::avx2 }) {
+            if (is_supported(kernel)) {
+                return kernel;
+            }
+        }
+        return simd_kernel::scalar;
+    }();
+    return best;
+}
+
+// ----------------------------------------------------------------------------
+
+void select_kernel(simd_kernel kernel_) {
+    // Fall back to the best supported instruction set below the requested one
+    auto kernel = std::min(kernel_, get_best_kernel());
+    while (!is_supported(kernel)) {
+        kernel = static_cast<simd_kernel>(static_cast<int>(kernel) - 1);
+    }
+
+    selected_kernel().store(kernel, std::memory_order_relaxed);
+    selected_kernels().store(&get_kernel_table(kernel), std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] simd_kernel get_selected_kernel() {
+    return selected_kernel().load(std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] const kernel_table& get_kernels() {
+    return *selected_kernels().load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,110 @@
+#ifndef LARGE_UNSIGNED_INTEGER_KERNELS_HPP
+#define LARGE_UNSIGNED_INTEGER_KERNELS_HPP
+
+#include "large_unsigned_integer.hpp"
+
+#if defined(LARGE_UNSIGNED_INTEGER_64_BIT_LIMBS) && defined(__x86_64__)
+#include <immintrin.h>
+#define LARGE_UNSIGNED_INTEGER_USE_CARRY_INTRINSICS
+#if defined(__BMI2__)
+#define LARGE_UNSIGNED_INTEGER_USE_MULX
+#endif
+#endif
+
+#include <compare>
+#include <cstddef>
+
+// ----------------------------------------------------------------------------
+// Linear kernels on raw limbs shared by the large_unsigned_integer operations
+
+namespace details::kernels {
+
+using underlying_type = large_unsigned_integer::underlying_type;
+using extended_type = large_unsigned_integer::extended_type;
+
+constexpr const auto nb_extended_type_bits = large_unsigned_integer::nb_extended_type_bits;
+
+// ------------------------------------------------------------------------
+// Carry propagating primitives, they use the carry intrinsics (and mulx when
+// BMI2 is enabled) with 64-bit limbs on x86-64 and extended_type arithmetic otherwise
+
+// lhs_ + rhs_ + carry_, carry_ is updated
+[[nodiscard]] inline underlying_type add_with_carry(underlying_type lhs_, underlying_type rhs_, bool& carry_) {
+#if defined(LARGE_UNSIGNED_INTEGER_USE_CARRY_INTRINSICS)
+    unsigned long long sum;
+    carry_ = _addcarry_u64(carry_, lhs_, rhs_, &sum) != 0;
+    return sum;
+#else
+    const extended_type sum = extended_type{ lhs_ } + rhs_ + carry_;
+    carry_ = (sum >> nb_extended_type_bits) != 0;
+    return static_cast<underlying_type>(sum);
+#endif
+}
+
+// lhs_ - rhs_ - borrow_, borrow_ is updated
+[[nodiscard]] inline underlying_type subtract_with_borrow(underlying_type lhs_, underlying_type rhs_, bool& borrow_) {
+#if defined(LARGE_UNSIGNED_INTEGER_USE_CARRY_INTRINSICS)
+    unsigned long long difference;
+    borrow_ = _subborrow_u64(borrow_, lhs_, rhs_, &difference) != 0;
+    return difference;
+#else
+    const underlying_type difference = lhs_ - rhs_ - static_cast<underlying_type>(borrow_);
+    borrow_ = (lhs_ < rhs_) || (lhs_ == rhs_ && borrow_);
+    return difference;
+#endif
+}
+
+// lhs_ * rhs_ + addend_ + carry_, the upper limb is returned in carry_
+[[nodiscard]] inline underlying_type multiply_add(underlying_type lhs_, underlying_type rhs_, underlying_type addend_, underlying_type& carry_) {
+#if defined(LARGE_UNSIGNED_INTEGER_USE_MULX)
+    unsigned long long high;
+    underlying_type low = _mulx_u64(lhs_, rhs_, &high);
+
+    bool carry = false;
+    low = add_with_carry(low, addend_, carry);
+    high += carry;
+
+    carry = false;
+    low = add_with_carry(low, carry_, carry);
+    carry_ = high + carry;
+    return low;
+#else
+    const extended_type value = extended_type{ lhs_ } * rhs_ + addend_ + carry_;
+    carry_ = static_cast<underlying_type>(value >> nb_extended_type_bits);
+    return static_cast<underlying_type>(value);
+#endif
+}
+
+// ------------------------------------------------------------------------
+// Set of kernels of one instruction set, result_ may alias lhs_ in all of them
+
+struct kernel_table {
+    // result_ = lhs_ + rhs_ + carry_ on size_ limbs, return the carry out
+    bool (*add)(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool carry_);
+
+    // result_ = lhs_ - rhs_ - borrow_ on size_ limbs, return the borrow out
+    bool (*subtract)(underlying_type* result_, const underlying_type* lhs_, const underlying_type* rhs_, size_t size_, bool borrow_);
+
+    // Compare 2 numbers of size_ limbs
+    std::strong_ordering (*compare)(const underlying_type* lhs_, const underlying_type* rhs_, size_t size_);
+
+    // result_ = lhs_ * factor_ + carry_ on size_ limbs, return the upper limb
+    underlying_type (*multiply_add)(underlying_type* result_, const underlying_type* lhs_, size_t size_, underlying_type factor_, underlying_type carry_);
+};
+
+// Kernels of the given instruction set, which must be supported
+[[nodiscard]] const kernel_table& get_kernel_table(large_unsigned_integer::simd_kernel kernel_);
+
+// Most capable instruction set supported by the current processor
+[[nodiscard]] large_unsigned_integer::simd_kernel get_best_kernel();
+
+// Instruction set used by get_kernels, kernel_ falls back to the best supported one
+void select_kernel(large_unsigned_integer::simd_kernel kernel_);
+[[nodiscard]] large_unsigned_integer::simd_kernel get_selected_kernel();
+
+// Kernels of the selected instruction set
+[[nodiscard]] const kernel_table& get_kernels();
+
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+// ----------------------------------------------------------------------------
+// Contiguous collection that stores up to inline_capacity values in place and
+// only allocates from its memory resource beyond that. Values must be trivially copyable.
+// As with the std::pmr containers, the resource is kept by move construction but not by
+// copy construction, and assignments never change it.
+template< typename T, size_t inline_capacity >
+    requires std::is_trivially_copyable_v< T >
+class small_vector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator< iterator >;
+    using const_reverse_iterator = std::reverse_iterator< const_iterator >;
+
+    // Constructors
+    small_vector() = default;
+
+    explicit small_vector(std::pmr::memory_resource* resource_)
+        : resource(resource_) {}
+
+    explicit small_vector(size_t count_)
+        : small_vector(count_, T{}) {}
+
+    small_vector(size_t count_, const T& value_, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+        : resource(resource_) {
+        resize(count_, value_);
+    }
+
+    template< std::input_iterator InputIt >
+    small_vector(InputIt first_, InputIt last_, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+        : resource(resource_) {
+        assign(first_, last_);
+    }
+
+    small_vector(std::initializer_list< T > values_, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+        : small_vector(values_.begin(), values_.end(), resource_) {}
+
+    small_vector(const small_vector& other_) {
+        assign(other_.begin(), other_.end());
+    }
+
+    small_vector(small_vector&& other_) noexcept
+        : resource(other_.resource) {
+        steal(std::move(other_));
+    }
+
+    ~small_vector() {
+        release();
+    }
+
+    small_vector& operator=(const small_vector& other_) {
+        if (this != &other_) {
+            assign(other_.begin(), other_.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other_) {
+        if (this == &other_) {
+            return *this;
+        }
+
+        // Storage can only be transferred between identical resources
+        if (resource != other_.resource && *resource != *other_.resource) {
+            assign(other_.begin(), other_.end());
+            other_.clear();
+        }
+        else {
+            release();
+            steal(std::move(other_));
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list< T > values_) {
+        assign(values_.begin(), values_.end());
+        return *this;
+    }
+
+    template< std::input_iterator InputIt >
+    void assign(InputIt first_, InputIt last_) {
+        clear();
+        if constexpr (std::forward_iterator< InputIt >) {
+            reserve(static_cast< size_t >(std::distance(first_, last_)));
+        }
+        for (; first_ != last_; ++first_) {
+            push_back(*first_);
+        }
+    }
+
+    // Element access
+    [[nodiscard]] T& operator[](size_t index_) { assert(index_ < count); return storage[index_]; }
+    [[nodiscard]] const T& operator[](size_t index_) const { assert(index_ < count); return storage[index_]; }
+
+    [[nodiscard]] T& front() { assert(!empty()); return storage[0]; }
+    [[nodiscard]] const T& front() const { assert(!empty()); return storage[0]; }
+    [[nodiscard]] T& back() { assert(!empty()); return storage[count - 1]; }
+    [[nodiscard]] const T& back() const { assert(!empty()); return storage[count - 1]; }
+
+    [[nodiscard]] T* data() { return storage; }
+    [[nodiscard]] const T* data() const { return storage; }
+
+    // Iterators
+    [[nodiscard]] iterator begin() { return storage; }
+    [[nodiscard]] const_iterator begin() const { return storage; }
+    [[nodiscard]] iterator end() { return storage + count; }
+    [[nodiscard]] const_iterator end() const { return storage + count; }
+
+    [[nodiscard]] reverse_iterator rbegin() { return reverse_iterator(end()); }
+    [[nodiscard]] const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() { return reverse_iterator(begin()); }
+    [[nodiscard]] const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    // Capacity
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] size_t capacity() const { return allocated; }
+
+    [[nodiscard]] std::pmr::memory_resource* get_resource() const { return resource; }
+
+    // True as long as the values are stored in place, without any allocation
+    [[nodiscard]] bool is_inline() const { return storage == buffer.data(); }
+
+    void reserve(size_t capacity_) {
+        if (capacity_ > allocated) {
+            reallocate(capacity_);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (!is_inline() && count < allocated) {
+            reallocate(count);
+        }
+    }
+
+    // Modifiers
+    void clear() { count = 0; }
+
+    void push_back(const T& value_) {
+        emplace_back(value_);
+    }
+
+    template< typename ... Args >
+    T& emplace_back(Args&&... args) {
+        if (count == allocated) [[unlikely]] {
+            // The arguments may refer to the current values, they are read before the storage is released
+            T value(std::forward< Args >(args)...);
+            reallocate(std::max(2 * allocated, count + 1));
+            storage[count] = std::move(value);
+            return storage[count++];
+        }
+
+        storage[count] = T(std::forward< Args >(args)...);
+        return storage[count++];
+    }
+
+    void pop_back() {
+        assert(!empty());
+        --count;
+    }
+
+    void resize(size_t count_) {
+        resize(count_, T{});
+    }
+
+    void resize(size_t count_, const T& value_) {
+        if (count_ > count) {
+            // value_ may refer to a current value, it is read before the storage is released
+            const T value = value_;
+            if (count_ > allocated) {
+                reallocate(std::max(2 * allocated, count_));
+            }
+            std::fill(storage + count, storage + count_, value);
+        }
+        count = count_;
+    }
+
+    iterator erase(const_iterator first_, const_iterator last_) {
+        auto* first = storage + (first_ - storage);
+        auto* last = storage + (last_ - storage);
+        auto* new_end = std::copy(last, end(), first);
+        count = static_cast< size_t >(new_end - storage);
+        return first;
+    }
+
+    // Comparison
+    [[nodiscard]] friend bool operator==(const small_vector& lhs_, const small_vector& rhs_) {
+        return std::equal(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+    }
+
+private:
+    // Move the values into a storage of the given capacity, back in place if it fits
+    void reallocate(size_t capacity_) {
+        assert(capacity_ >= count);
+
+        T* new_storage = buffer.data();
+        if (capacity_ > inline_capacity) {
+            new_storage = static_cast< T* >(resource->allocate(capacity_ * sizeof(T), alignof(T)));
+        }
+        else {
+            capacity_ = inline_capacity;
+        }
+
+        if (new_storage != storage) {
+            std::copy(storage, storage + count, new_storage);
+            release();
+            storage = new_storage;
+        }
+        allocated = capacity_;
+    }
+
+    // Give the storage back to the resource, if any
+    void release() {
+        if (!is_inline()) {
+            resource->deallocate(storage, allocated * sizeof(T), alignof(T));
+        }
+        storage = buffer.data();
+        allocated = inline_capacity;
+    }
+
+    // Take the values of other_ that is left empty, the allocated storage is transferred without copy
+    void steal(small_vector&& other_) {
+        if (other_.is_inline()) {
+            std::copy(other_.begin(), other_.end(), buffer.data());
+        }
+        else {
+            storage = std::exchange(other_.storage, other_.buffer.data());
+            allocated = std::exchange(other_.allocated, inline_capacity);
+        }
+        count = std::exchange(other_.count, 0);
+    }
+
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+    T* storage = buffer.data();
+    size_t count = 0;
+    size_t allocated = inline_capacity;
+    std::array< T, inline_capacity > buffer;
+};
+
+#endif
@@ -1,72 +1,211 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <stop_token>
 #include <thread>
-#include <vector>
+#include <utility>
+
+// ----------------------------------------------------------------------------
+// Wait strategies of the consumer while the queue is empty.
+// wait returns once ready_() is true or stop_ is requested, notify is called by
+// the producer after every publication.
+
+namespace details {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+}
+
+// Busy wait for a few iterations then give the processor back at each iteration,
+// lowest latency but the consumer keeps a core busy
+class spin_yield_wait_strategy {
+public:
+    spin_yield_wait_strategy() = default;
+
+    explicit spin_yield_wait_strategy(size_t nb_spins_)
+        : nb_spins(nb_spins_) {}
+
+    template< typename Ready >
+    void wait(Ready ready_, std::stop_token stop_) {
+        for (size_t iteration = 0; !ready_(); ++iteration) {
+            if (stop_.stop_requested()) {
+                return;
+            }
+
+            if (iteration < nb_spins) {
+                details::cpu_relax();
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void notify() {}
+
+private:
+    size_t nb_spins = 64;
+};
+
+// Sleep with std::atomic::wait (a futex on Linux) until the producer or a stop request wakes it up,
+// the producer only pays for a notification when the consumer is actually sleeping
+class atomic_wait_strategy {
+public:
+    atomic_wait_strategy() = default;
+
+    // The wait state is not copied, strategies are only copied as configuration before being used
+    atomic_wait_strategy(const atomic_wait_strategy&) {}
+    atomic_wait_strategy& operator=(const atomic_wait_strategy&) = delete;
+
+    template< typename Ready >
+    void wait(Ready ready_, std::stop_token stop_) {
+        if (ready_()) {
+            return;
+        }
+
+        std::stop_callback wake_on_stop(stop_, [this]() { wake(); });
+        while (true) {
+            uint32_t const current_sequence = sequence.load(std::memory_order_acquire);
+
+            // The flag must be visible before the last check, it pairs with the fence of notify
+            waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ready_() || stop_.stop_requested()) {
+                break;
+            }
+
+            sequence.wait(current_sequence, std::memory_order_acquire);
+        }
+        waiting.store(false, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed)) [[unlikely]] {
+            wake();
+        }
+    }
+
+private:
+    void wake() {
+        sequence.fetch_add(1, std::memory_order_release);
+        sequence.notify_one();
+    }
+
+    std::atomic_uint32_t sequence{ 0 };
+    std::atomic_bool waiting{ false };
+};
+
+// Spin for a bounded number of iterations, which covers a producer that is just behind, then sleep
+class hybrid_wait_strategy {
+public:
+    hybrid_wait_strategy() = default;
+
+    explicit hybrid_wait_strategy(size_t nb_spins_)
+        : nb_spins(nb_spins_) {}
+
+    template< typename Ready >
+    void wait(Ready ready_, std::stop_token stop_) {
+        for (size_t iteration = 0; iteration < nb_spins; ++iteration) {
+            if (ready_() || stop_.stop_requested()) {
+                return;
+            }
+            details::cpu_relax();
+        }
 
-template< typename T >
+        sleeper.wait(ready_, stop_);
+    }
+
+    void notify() {
+        sleeper.notify();
+    }
+
+private:
+    size_t nb_spins = 1024;
+    atomic_wait_strategy sleeper;
+};
+
+// ----------------------------------------------------------------------------
+
+// Unbounded queue built from a linked list of fixed-size segments, growing never copies the
+// values nor stalls the consumer. The segments released by the consumer are recycled by the producer,
+// and the producer waits for the consumer when the segments in use would exceed the high-water mark.
+template< typename T, typename WaitStrategy = hybrid_wait_strategy >
 class spsc_queue {
 public:
-    static constexpr size_t DefaultCapacity = 1024;
-    static constexpr size_t DefaultIncrement = 1024;
+    static constexpr size_t DefaultSegmentCapacity = 1024;
+    static constexpr size_t Unbounded = std::numeric_limits< size_t >::max();
+
+    // The segment capacity is rounded up to a power of two, the high-water mark is in bytes
+    // of segments in use and at least 2 segments are always allowed
+    explicit spsc_queue(size_t segment_capacity_ = DefaultSegmentCapacity, size_t high_water_mark_ = Unbounded, const WaitStrategy& wait_strategy_ = {})
+        : mask(std::bit_ceil(std::max(segment_capacity_, size_t{ 1 })) - 1)
+        , max_nb_segments(std::max(high_water_mark_ / ((mask + 1) * sizeof(T)), size_t{ 2 }))
+        , producer_wait_strategy(wait_strategy_)
+        , wait_strategy(wait_strategy_) {
+        first_segment = new segment(mask + 1);
+        producer_segment = first_segment;
+        cached_consumer_segment = first_segment;
+        consumer_segment.store(first_segment, std::memory_order_relaxed);
+    }
 
-    spsc_queue()
-        : spsc_queue(DefaultCapacity, DefaultIncrement) {}
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
 
-    spsc_queue(size_t capacity_, size_t increment_ = DefaultIncrement)
-        : collection(std::make_shared< std::vector< T > >(capacity_))
-        , increment(increment_) {}
+    ~spsc_queue() {
+        while (first_segment != nullptr) {
+            delete std::exchange(first_segment, first_segment->next.load(std::memory_order_relaxed));
+        }
+    }
 
     template< typename ... Args >
     void emplace(Args&&... args) {
-        size_t       current_producer_index = producer_index.load(std::memory_order_relaxed);
-        size_t const current_consumer_index = consumer_index.load(std::memory_order_acquire);
+        std::ignore = emplace(std::stop_token{}, std::forward< Args >(args)...);
+    }
 
-        size_t next_producer_index = next_index(current_producer_index);
-        if (next_producer_index == current_consumer_index) [[unlikely]] {
-            // Queue is nearly full
-            std::tie(current_producer_index, next_producer_index) = resize(current_consumer_index);
+    // Return false if stop is requested while waiting for the consumer to release memory
+    template< typename ... Args >
+    [[nodiscard]] bool emplace(std::stop_token stop_, Args&&... args) {
+        size_t const current_producer_index = producer_index.load(std::memory_order_relaxed);
+        size_t const slot = current_producer_index & mask;
+        if (slot == 0 && current_producer_index != 0) [[unlikely]] {
+            // Current segment is full
+            if (!append_segment(stop_)) {
+                return false;
+            }
         }
 
-        (*(collection.load(std::memory_order_relaxed)))[current_producer_index] = T(std::forward< Args >(args)...);
-        producer_index.store(next_producer_index, std::memory_order_release);
+        producer_segment->values[slot] = T(std::forward< Args >(args)...);
+        producer_index.store(current_producer_index + 1, std::memory_order_release);
+        wait_strategy.notify();
+        return true;
     }
 
     [[nodiscard]] T pop() {
         size_t const current_consumer_index = consumer_index.load(std::memory_order_relaxed);
-        size_t       current_producer_index = producer_index.load(std::memory_order_acquire);
-
-        while (empty(current_consumer_index, current_producer_index)) {
-            std::this_thread::yield();
-            current_producer_index = producer_index.load(std::memory_order_acquire);
-        }
-
-        T data = (*(collection.load(std::memory_order_acquire)))[current_consumer_index];
-        size_t const next_consumer_index = next_index(current_consumer_index);
-        consumer_index.store(next_consumer_index, std::memory_order_release);
-
-        return data;
+        wait_until_not_empty(current_consumer_index, {});
+        return pop_at(current_consumer_index);
     }
 
     // Will pop data even if stop is requested to allow emptying the queue
     [[nodiscard]] std::optional< T > pop(std::stop_token stop_) {
         size_t const current_consumer_index = consumer_index.load(std::memory_order_relaxed);
-        size_t       current_producer_index = producer_index.load(std::memory_order_acquire);
-
-        while (empty(current_consumer_index, current_producer_index)) {
-            if (stop_.stop_requested()) [[unlikely]] {
-                return {};
-            }
-
-            std::this_thread::yield();
-            current_producer_index = producer_index.load(std::memory_order_acquire);
+        if (!wait_until_not_empty(current_consumer_index, stop_)) [[unlikely]] {
+            return {};
         }
 
-        T data = (*(collection.load(std::memory_order_acquire)))[current_consumer_index];
-        size_t const next_consumer_index = next_index(current_consumer_index);
-        consumer_index.store(next_consumer_index, std::memory_order_release);
-
-        return std::make_optional< T >(data);
+        return std::make_optional< T >(pop_at(current_consumer_index));
     }
 
     [[nodiscard]] bool empty() {
@@ -75,33 +214,106 @@ public:
         return empty(current_consumer_index, current_producer_index);
     }
 
+    [[nodiscard]] size_t segment_capacity() const { return mask + 1; }
+
+    // Segments allocated so far, in use or waiting to be recycled, only meaningful on the producer side
+    [[nodiscard]] size_t nb_allocated_segments() const { return nb_allocated; }
+
 private:
-    [[nodiscard]] inline std::size_t next_index(size_t const& index_) {
-        return (index_ + 1) % collection.load()->size();
+    struct segment {
+        explicit segment(size_t capacity_)
+            : values(std::make_unique< T[] >(capacity_)) {}
+
+        std::unique_ptr< T[] > values;
+        std::atomic< segment* > next{ nullptr };
+    };
+
+    // Return false if the queue is still empty because of a stop request
+    bool wait_until_not_empty(size_t current_consumer_index_, std::stop_token stop_) {
+        auto const not_empty = [this, current_consumer_index_]() {
+            return !empty(current_consumer_index_, producer_index.load(std::memory_order_acquire));
+        };
+
+        wait_strategy.wait(not_empty, stop_);
+        return not_empty();
     }
 
     [[nodiscard]] inline bool empty(size_t current_consumer_index_, size_t current_producer_index_) {
         return current_consumer_index_ == current_producer_index_;
     }
 
-    // Return the new producer index and the next producer index
-    [[nodiscard]] std::tuple< size_t, size_t > resize(size_t current_consumer_index_) {
-        auto old_collection = collection.load(std::memory_order_acquire);
-        auto new_collection = std::make_shared< std::vector< T > >(old_collection->size() + increment);
+    // The value must have been published
+    [[nodiscard]] T pop_at(size_t current_consumer_index_) {
+        size_t const slot = current_consumer_index_ & mask;
+        segment* current_segment = consumer_segment.load(std::memory_order_relaxed);
+        if (slot == 0 && current_consumer_index_ != 0) [[unlikely]] {
+            // The producer linked the next segment before publishing its first value
+            current_segment = current_segment->next.load(std::memory_order_acquire);
+            consumer_segment.store(current_segment, std::memory_order_release);
+            nb_released_segments.fetch_add(1, std::memory_order_release);
+            producer_wait_strategy.notify();
+        }
 
-        std::copy(std::begin(*old_collection) + current_consumer_index_, std::end(*old_collection), std::begin(*new_collection) + current_consumer_index_);
-        std::copy(std::begin(*old_collection), std::begin(*old_collection) + current_consumer_index_, std::begin(*new_collection) + old_collection->size());
+        T data = std::move(current_segment->values[slot]);
+        consumer_index.store(current_consumer_index_ + 1, std::memory_order_release);
+        return data;
+    }
 
-        collection.store(new_collection, std::memory_order_release);
+    // Link a recycled or new segment after the producer one, return false on stop request
+    [[nodiscard]] bool append_segment(std::stop_token stop_) {
+        auto const has_room = [this]() {
+            return nb_linked_segments + 1 - nb_released_segments.load(std::memory_order_acquire) < max_nb_segments;
+        };
+        if (!has_room()) {
+            producer_wait_strategy.wait(has_room, stop_);
+            if (!has_room()) {
+                return false;
+            }
+        }
+
+        segment* new_segment = recycle_segment();
+        if (new_segment == nullptr) {
+            new_segment = new segment(mask + 1);
+            ++nb_allocated;
+        }
+
+        producer_segment->next.store(new_segment, std::memory_order_release);
+        producer_segment = new_segment;
+        ++nb_linked_segments;
+        return true;
+    }
 
-        auto new_current_producer_index = old_collection->size() + current_consumer_index_ - 1;
-        return { new_current_producer_index, new_current_producer_index + 1 };
+    // The segments before the consumer one have been fully consumed
+    [[nodiscard]] segment* recycle_segment() {
+        if (first_segment == cached_consumer_segment) {
+            cached_consumer_segment = consumer_segment.load(std::memory_order_acquire);
+            if (first_segment == cached_consumer_segment) {
+                return nullptr;
+            }
+        }
+
+        segment* recycled_segment = std::exchange(first_segment, first_segment->next.load(std::memory_order_relaxed));
+        recycled_segment->next.store(nullptr, std::memory_order_relaxed);
+        return recycled_segment;
     }
 
-    std::atomic_size_t producer_index{ 0 };
-    std::atomic_size_t consumer_index{ 0 };
+    size_t const mask;
+    size_t const max_nb_segments;
+
+    // Producer side
+    alignas(64) std::atomic_size_t producer_index{ 0 };
+    segment* producer_segment = nullptr;
+    segment* first_segment = nullptr; // Oldest segment, the ones up to the consumer segment are free
+    segment* cached_consumer_segment = nullptr;
+    size_t nb_linked_segments = 0;
+    size_t nb_allocated = 1;
+    WaitStrategy producer_wait_strategy;
 
-    std::atomic< std::shared_ptr< std::vector< T > > > collection{};
+    // Consumer side, the consumer waits on wait_strategy and the producer on producer_wait_strategy
+    alignas(64) std::atomic_size_t consumer_index{ 0 };
+    std::atomic< segment* > consumer_segment{ nullptr };
+    std::atomic_size_t nb_released_segments{ 0 };
+    WaitStrategy wait_strategy;
+};
 
-    size_t increment{ DefaultIncrement };
-};
\ No newline at end of file
+#endif
@@ -1,70 +1,253 @@
 #include "square_root.hpp"
 
-[[nodiscard]] unsigned int get_next_digit_to_evaluate(unsigned int x_, bool smaller_than_current_remainder_) {
-    //      5
-    //    3   7
-    //   1 4 6 8
-    //  0 2     9
-    constexpr const std::array<unsigned int, 10> next_value_if_larger{ 0, 0, 2, 1, 4, 3, 6, 6, 8, 9 };
-    constexpr const std::array<unsigned int, 10> next_value_if_smaller{ 0, 2, 2, 4, 4, 7, 6, 8, 9, 9 };
-
-    if (smaller_than_current_remainder_) {
-        return next_value_if_smaller[x_];
-    } else {
-        return next_value_if_larger[x_];
+#include <bit>
+#include <cerrno>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SQUARE_ROOT_HAS_SIMD_KERNELS
+#define SQUARE_ROOT_TARGET_AVX2 __attribute__((target("avx2")))
+#define SQUARE_ROOT_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SQUARE_ROOT_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define SQUARE_ROOT_ALWAYS_INLINE inline
+#endif
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Approximate the value of the limbs from index_ and up, scaled by base^-index_
+[[nodiscard]] long double leading_limbs_as_floating_point(const large_unsigned_integer::collection_type& data_, size_t index_) {
+    long double value = 0.0L;
+    for (size_t index = data_.size(); index > index_; --index) {
+        value = std::ldexp(value, large_unsigned_integer::nb_extended_type_bits) + static_cast<long double>(data_[index - 1]);
     }
+    return value;
 }
 
-[[nodiscard]] std::tuple<unsigned int, large_unsigned_integer> compute_next_digit(const large_unsigned_integer& current_remainder_, const large_unsigned_integer& result_) {
-    // find x * (20p + x) <= remainder*100+current
-    const auto expanded_result = result_ * 20u;
+// ----------------------------------------------------------------------------
+// Estimate the largest y such that y * (twice_result + y) <= remainder using
+// only the leading limbs, the estimate is off by at most one unit
+[[nodiscard]] long double estimate_next_root_digit(const large_unsigned_integer& remainder_, const large_unsigned_integer& twice_result_) {
+    const auto& remainder_data = remainder_.get_data();
+    if (remainder_data.empty()) {
+        return 0.0L;
+    }
 
-    unsigned int x{ 5 };
-    std::array<large_unsigned_integer, 10> sum{ 0u };
-    std::array<bool, 10> smaller_than_current_remainder{ true };
+    // Keep enough limbs to saturate the precision of a long double
+    constexpr const size_t nb_leading_limbs = 3;
+    const size_t index = remainder_data.size() > nb_leading_limbs ? remainder_data.size() - nb_leading_limbs : 0;
+    const auto exponent = static_cast<int>(index * large_unsigned_integer::nb_extended_type_bits);
 
-    // Use dichotomic search to find the next number
-    while (true) {
-        // Early optimization for 0 to avoid computing the sum and the comparison as it's always 0 and smaller
-        if (x == 0) {
-            return { x, sum[x] };
+    const long double r = leading_limbs_as_floating_point(remainder_data, index);
+    const long double d = leading_limbs_as_floating_point(twice_result_.get_data(), index);
+
+    // Numerically stable root of y^2 + d*y - r = 0 (the scaled r term vanishes for large numbers)
+    return std::floor(2.0L * r / (d + std::sqrt(d * d + std::ldexp(4.0L * r, -exponent))));
+}
+
+// ----------------------------------------------------------------------------
+// Binary checkpoint format
+
+constexpr const std::array<char, 8> checkpoint_magic{ 'S', 'Q', 'R', 'T', 'C', 'K', 'P', 'T' };
+constexpr const uint8_t checkpoint_version = 1;
+
+void write_uint64(std::ostream& stream_, uint64_t value_) {
+    std::array<char, 8> bytes;
+    for (auto& byte : bytes) {
+        byte = static_cast<char>(value_ & 0xFF);
+        value_ >>= 8;
+    }
+    stream_.write(bytes.data(), bytes.size());
+}
+
+[[nodiscard]] uint64_t read_uint64(std::istream& stream_) {
+    std::array<unsigned char, 8> bytes;
+    if (!stream_.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+        throw std::runtime_error("Truncated checkpoint");
+    }
+
+    uint64_t value = 0;
+    for (auto byte : std::views::reverse(bytes)) {
+        value = (value << 8) | byte;
+    }
+    return value;
+}
+
+// Number of limbs then the limbs, least significant first
+void write_large_integer(std::ostream& stream_, const large_unsigned_integer& value_) {
+    const auto& data = value_.get_data();
+    write_uint64(stream_, data.size());
+
+    std::vector<char> bytes(data.size() * sizeof(large_unsigned_integer::underlying_type));
+    for (size_t index = 0; index < bytes.size(); ++index) {
+        bytes[index] = static_cast<char>(data[index / sizeof(large_unsigned_integer::underlying_type)] >> (8 * (index % sizeof(large_unsigned_integer::underlying_type))));
+    }
+    stream_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// The limbs are repacked when they were saved with another limb size
+[[nodiscard]] large_unsigned_integer read_large_integer(std::istream& stream_, size_t limb_size_) {
+    using underlying_type = large_unsigned_integer::underlying_type;
+
+    const uint64_t nb_limbs = read_uint64(stream_);
+    if (nb_limbs > std::numeric_limits<size_t>::max() / limb_size_ / 2) {
+        throw std::runtime_error("Invalid checkpoint");
+    }
+
+    // Read by bounded pieces so that a corrupt number of limbs does not allocate more than the stream holds
+    constexpr const size_t max_piece_size = size_t{ 1 } << 20;
+    std::vector<unsigned char> bytes;
+    for (size_t remaining = nb_limbs * limb_size_; remaining > 0;) {
+        const size_t piece_size = std::min(remaining, max_piece_size);
+        const size_t offset = bytes.size();
+        bytes.resize(offset + piece_size);
+        if (!stream_.read(reinterpret_cast<char*>(bytes.data() + offset), static_cast<std::streamsize>(piece_size))) {
+            throw std::runtime_error("Truncated checkpoint");
         }
+        remaining -= piece_size;
+    }
 
-        sum[x] = (expanded_result + x) * x;
-        smaller_than_current_remainder[x] = sum[x] <= current_remainder_;
+    large_unsigned_integer::collection_type data((bytes.size() + sizeof(underlying_type) - 1) / sizeof(underlying_type), 0);
+    for (size_t index = 0; index < bytes.size(); ++index) {
+        data[index / sizeof(underlying_type)] |= static_cast<underlying_type>(bytes[index]) << (8 * (index % sizeof(underlying_type)));
+    }
+    while (!data.empty() && data.back() == 0) {
+        data.pop_back();
+    }
+    return large_unsigned_integer(std::move(data));
+}
+
+#if defined(__unix__)
+
+// ----------------------------------------------------------------------------
+// Write bytes_ to path_ and wait until they are on disk, so that a rename publishes complete contents
+void write_file_durably(const std::filesystem::path& path_, std::string_view bytes_) {
+    const int file_descriptor = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file_descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot write checkpoint " + path_.string());
+    }
 
-        const auto next_x = get_next_digit_to_evaluate(x, smaller_than_current_remainder[x]);
+    const auto fail = [&](const char* operation_) {
+        const int error = errno;
+        ::close(file_descriptor);
+        throw std::system_error(error, std::generic_category(), operation_);
+    };
 
-        if (x == next_x) {
-            if (smaller_than_current_remainder[x]) {
-                return { x, sum[x] };
-            } else {
-                return { x - 1, sum[x - 1] };
+    while (!bytes_.empty()) {
+        const ssize_t nb_written = ::write(file_descriptor, bytes_.data(), bytes_.size());
+        if (nb_written < 0) {
+            if (errno == EINTR) {
+                continue;
             }
+            fail("write");
         }
+        bytes_.remove_prefix(static_cast<size_t>(nb_written));
+    }
+
+    if (::fsync(file_descriptor) != 0) {
+        fail("fsync");
+    }
+    if (::close(file_descriptor) != 0) {
+        throw std::system_error(errno, std::generic_category(), "close");
+    }
+}
 
-        x = next_x;
+// ----------------------------------------------------------------------------
+// Make the renames in directory_ durable
+void sync_directory(const std::filesystem::path& directory_) {
+    const int file_descriptor = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (file_descriptor < 0) {
+        throw std::system_error(errno, std::generic_category(), "open");
+    }
+
+    const int result = ::fsync(file_descriptor);
+    const int error = errno;
+    ::close(file_descriptor);
+    if (result != 0) {
+        throw std::system_error(error, std::generic_category(), "fsync");
     }
 }
 
+#endif
+
+} // Anonymous namespace
+
 // ----------------------------------------------------------------------------
 
 namespace details {
 
-[[nodiscard]] unsigned int square_root_next_digit_computer::operator()(auto current_) {
+square_root_next_digit_computer::square_root_next_digit_computer(std::pmr::memory_resource* resource_)
+    : remainder(resource_)
+    , twenty_result(resource_)
+    , trial(resource_)
+    , next_trial(resource_) {}
+
+// ----------------------------------------------------------------------------
+
+square_root_next_digit_computer::square_root_next_digit_computer(const large_unsigned_integer& remainder_, const large_unsigned_integer& twenty_result_, std::pmr::memory_resource* resource_)
+    : square_root_next_digit_computer(resource_) {
+    remainder = remainder_;
+    twenty_result = twenty_result_;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] unsigned int square_root_next_digit_computer::operator()(unsigned int current_) {
     // find x * (20p + x) <= remainder*100+current
-    const large_unsigned_integer current_remainder = remainder * 100u + current_;
-    const auto [x, sum] = compute_next_digit(current_remainder, result);
+    remainder.mul_add(100u, current_);
+
+    auto x = static_cast<unsigned int>(std::clamp(estimate_next_root_digit(remainder, twenty_result), 0.0L, 9.0L));
+
+    // Check the estimate with a single product and correct it by at most one unit
+    compute_trial(x);
+    if (trial > remainder) {
+        --x;
+        compute_trial(x);
+    } else if (x < 9) {
+        // (x + 1) * (20p + x + 1) = x * (20p + x) + 20p + 2x + 1
+        next_trial = trial;
+        next_trial += twenty_result;
+        next_trial += 2 * x + 1;
+        if (next_trial <= remainder) {
+            std::swap(trial, next_trial);
+            ++x;
+        }
+    }
 
     assert(x < 10);
-    result = result * 10u + x;
-    remainder = current_remainder - sum;
+    assert(trial <= remainder);
+    remainder -= trial;
+
+    // 20p' = 10 * 20p + 20x
+    twenty_result.mul_add(10u, 20 * x);
 
     return x;
 }
 
 // ----------------------------------------------------------------------------
 
+void square_root_next_digit_computer::compute_trial(unsigned int x_) {
+    // Copy assignment reuses the capacity of trial
+    trial = twenty_result;
+    trial += x_;
+    trial *= x_;
+}
+
+// ----------------------------------------------------------------------------
+
 [[nodiscard]] bool square_root_next_digit_computer::has_next_digit() const {
     return remainder != 0u;
 }
@@ -78,4 +261,637 @@ generator<unsigned int> compute_fractional_part_of_square_root(square_root_next_
     }
 }
 
-}
\ No newline at end of file
+// ----------------------------------------------------------------------------
+
+generator<char> compute_fractional_part_of_square_root(square_root_next_digit_computer& computer_, uint64_t value_, uint64_t nb_fractional_digits_, const square_root_checkpoint_policy& policy_) {
+    const bool take_snapshots = policy_.interval != 0 && policy_.save;
+    while (computer_.has_next_digit()) {
+        constexpr const unsigned int next_value = 0;
+        const auto digit = computer_(next_value);
+        ++nb_fractional_digits_;
+        co_yield to_char(digit);
+
+        // The digit has been consumed when the next one is requested
+        if (take_snapshots && nb_fractional_digits_ % policy_.interval == 0) {
+            policy_.save({ value_, nb_fractional_digits_, computer_.get_remainder(), computer_.get_twenty_result() });
+        }
+    }
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+namespace details {
+
+square_root_next_block_computer::square_root_next_block_computer(std::pmr::memory_resource* resource_)
+    : remainder(resource_)
+    , twice_result(resource_)
+    , trial(resource_)
+    , next_trial(resource_) {}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] square_root_next_block_computer::underlying_type square_root_next_block_computer::operator()(extended_type current_) {
+    // find y * (2pB + y) <= remainder*B^2+current
+    remainder.mul_add(block_base, static_cast<underlying_type>(current_ / block_base));
+    remainder.mul_add(block_base, static_cast<underlying_type>(current_ % block_base));
+
+    underlying_type y = estimate_next_block();
+
+    // The estimate is within a few units, fix it with as few trials as possible
+    compute_trial(y);
+    while (trial > remainder) {
+        --y;
+        compute_trial(y);
+    }
+
+    // (y + 1) * (2pB + y + 1) = y * (2pB + y) + 2pB + 2y + 1
+    while (y + 1 < block_base) {
+        next_trial = trial;
+        next_trial += twice_result;
+        next_trial += 2 * y + 1;
+        if (next_trial > remainder) {
+            break;
+        }
+
+        std::swap(trial, next_trial);
+        ++y;
+    }
+
+    remainder -= trial;
+
+    // 2p'B = (2pB + 2y) * B
+    twice_result += 2 * y;
+    twice_result *= block_base;
+
+    return y;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] bool square_root_next_block_computer::has_next_digit() const {
+    return remainder != 0u;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] square_root_next_block_computer::underlying_type square_root_next_block_computer::estimate_next_block() const {
+    constexpr const auto max_block = static_cast<long double>(block_base - 1);
+    return static_cast<underlying_type>(std::clamp(estimate_next_root_digit(remainder, twice_result), 0.0L, max_block));
+}
+
+// ----------------------------------------------------------------------------
+
+void square_root_next_block_computer::compute_trial(underlying_type y_) {
+    // Copy assignment reuses the capacity of trial
+    trial = twice_result;
+    trial += y_;
+    trial *= y_;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::string_view block_to_chars(square_root_next_block_computer::buffer_type& buffer_, large_unsigned_integer::underlying_type block_, unsigned int width_) {
+    assert(width_ <= buffer_.size());
+
+    const auto [end, error] = std::to_chars(buffer_.data(), buffer_.data() + buffer_.size(), block_);
+    assert(error == std::errc{});
+
+    // Left pad with zeros
+    const auto nb_chars = static_cast<unsigned int>(end - buffer_.data());
+    if (nb_chars < width_) {
+        std::copy_backward(buffer_.data(), end, buffer_.data() + width_);
+        std::fill_n(buffer_.data(), width_ - nb_chars, '0');
+        return { buffer_.data(), width_ };
+    }
+
+    return { buffer_.data(), nb_chars };
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Digit step of the lockstep computer, every loop over the lanes is branchless so
+// that it is vectorized for the instruction set of the function it is inlined in
+
+// The carries of the passes are biased so that only unsigned arithmetic is needed,
+// they stay far below the bias as the factors are at most 100
+constexpr const uint64_t lockstep_carry_bias = uint64_t{ 1 } << 16;
+constexpr const uint64_t lockstep_borrow = lockstep_carry_bias * ((uint64_t{ 1 } << 32) - 1);
+
+// The estimate is lowered by this margin, which is larger than its rounding error,
+// so that it is the digit or the digit minus one
+constexpr const double lockstep_estimate_margin = 1e-6;
+constexpr const size_t nb_lockstep_leading_limbs = 4;
+
+template<size_t NbLanes>
+SQUARE_ROOT_ALWAYS_INLINE void next_lockstep_digit(uint32_t* __restrict remainder_, uint32_t* __restrict next_remainder_, uint32_t* __restrict twenty_result_, size_t nb_limbs_, uint64_t* __restrict take_next_, unsigned int* digits_) {
+    // Estimate x from the leading limbs of 100 * remainder and twenty_result, as the scalar computer does
+    std::array<double, NbLanes> leading_remainder{};
+    std::array<double, NbLanes> leading_twenty_result{};
+    const size_t index = nb_limbs_ > nb_lockstep_leading_limbs ? nb_limbs_ - nb_lockstep_leading_limbs : 0;
+    for (size_t limb = nb_limbs_; limb > index; --limb) {
+        const size_t offset = (limb - 1) * NbLanes;
+        for (size_t lane = 0; lane < NbLanes; ++lane) {
+            const auto value = static_cast<uint32_t>((remainder_[offset + lane] & ~take_next_[lane]) | (next_remainder_[offset + lane] & take_next_[lane]));
+            leading_remainder[lane] = leading_remainder[lane] * 0x1p32 + static_cast<double>(value);
+            leading_twenty_result[lane] = leading_twenty_result[lane] * 0x1p32 + static_cast<double>(twenty_result_[offset + lane]);
+        }
+    }
+
+    std::array<uint64_t, NbLanes> x;
+    const double scale = std::ldexp(4.0, -static_cast<int>(32 * index));
+    for (size_t lane = 0; lane < NbLanes; ++lane) {
+        const double r = 100.0 * leading_remainder[lane];
+        const double d = leading_twenty_result[lane];
+        const double y = r == 0.0 ? 0.0 : 2.0 * r / (d + std::sqrt(d * d + scale * r));
+        x[lane] = static_cast<uint64_t>(std::clamp(y - lockstep_estimate_margin, 0.0, 9.0));
+    }
+
+    // A single pass per digit, each limb of twenty_result is read once for the 3 updates:
+    // remainder = 100 * remainder - x * (twenty_result + x), which is not negative,
+    // next_remainder = remainder - (twenty_result + 2x + 1) in case x + 1 fits as well,
+    // twenty_result = 10 * twenty_result + 20x
+    std::array<uint64_t, NbLanes> carry;
+    std::array<uint64_t, NbLanes> next_carry;
+    std::array<uint64_t, NbLanes> product_carry;
+    for (size_t lane = 0; lane < NbLanes; ++lane) {
+        carry[lane] = lockstep_carry_bias - x[lane] * x[lane];
+        next_carry[lane] = lockstep_carry_bias - (2 * x[lane] + 1);
+        product_carry[lane] = 20 * x[lane];
+    }
+    for (size_t limb = 0; limb < nb_limbs_; ++limb) {
+        const size_t offset = limb * NbLanes;
+        for (size_t lane = 0; lane < NbLanes; ++lane) {
+            const uint64_t value = (uint64_t{ remainder_[offset + lane] } & ~take_next_[lane]) | (uint64_t{ next_remainder_[offset + lane] } & take_next_[lane]);
+            const uint64_t twenty_result = twenty_result_[offset + lane];
+
+            const uint64_t sum = value * 100 + carry[lane] + lockstep_borrow - x[lane] * twenty_result;
+            remainder_[offset + lane] = static_cast<uint32_t>(sum);
+            carry[lane] = sum >> 32;
+
+            const uint64_t next_sum = (sum & 0xFFFFFFFF) + next_carry[lane] + lockstep_borrow - twenty_result;
+            next_remainder_[offset + lane] = static_cast<uint32_t>(next_sum);
+            next_carry[lane] = next_sum >> 32;
+
+            const uint64_t product = twenty_result * 10 + product_carry[lane];
+            twenty_result_[offset + lane] = static_cast<uint32_t>(product);
+            product_carry[lane] = product >> 32;
+        }
+    }
+    assert(std::ranges::all_of(carry, [](uint64_t carry_) { return carry_ == lockstep_carry_bias; }));
+
+    // The lanes where next_remainder is not negative take x + 1, their twenty_result gets 20 more
+    for (size_t lane = 0; lane < NbLanes; ++lane) {
+        take_next_[lane] = next_carry[lane] >= lockstep_carry_bias && x[lane] < 9 ? ~uint64_t{ 0 } : 0;
+        digits_[lane] = static_cast<unsigned int>(x[lane] + (take_next_[lane] & 1));
+        product_carry[lane] = take_next_[lane] & 20;
+    }
+    for (size_t limb = 0; limb < nb_limbs_; ++limb) {
+        const size_t offset = limb * NbLanes;
+        uint64_t any_carry = 0;
+        for (size_t lane = 0; lane < NbLanes; ++lane) {
+            const uint64_t sum = uint64_t{ twenty_result_[offset + lane] } + product_carry[lane];
+            twenty_result_[offset + lane] = static_cast<uint32_t>(sum);
+            product_carry[lane] = sum >> 32;
+            any_carry |= product_carry[lane];
+        }
+
+        // The carry rarely goes past the lowest limb
+        if (any_carry == 0) {
+            break;
+        }
+    }
+}
+
+template<size_t NbLanes>
+void next_lockstep_digit_scalar(uint32_t* remainder_, uint32_t* next_remainder_, uint32_t* twenty_result_, size_t nb_limbs_, uint64_t* take_next_, unsigned int* digits_) {
+    next_lockstep_digit<NbLanes>(remainder_, next_remainder_, twenty_result_, nb_limbs_, take_next_, digits_);
+}
+
+#if defined(SQUARE_ROOT_HAS_SIMD_KERNELS)
+
+template<size_t NbLanes>
+SQUARE_ROOT_TARGET_AVX2 void next_lockstep_digit_avx2(uint32_t* remainder_, uint32_t* next_remainder_, uint32_t* twenty_result_, size_t nb_limbs_, uint64_t* take_next_, unsigned int* digits_) {
+    next_lockstep_digit<NbLanes>(remainder_, next_remainder_, twenty_result_, nb_limbs_, take_next_, digits_);
+}
+
+template<size_t NbLanes>
+SQUARE_ROOT_TARGET_AVX512 void next_lockstep_digit_avx512(uint32_t* remainder_, uint32_t* next_remainder_, uint32_t* twenty_result_, size_t nb_limbs_, uint64_t* take_next_, unsigned int* digits_) {
+    next_lockstep_digit<NbLanes>(remainder_, next_remainder_, twenty_result_, nb_limbs_, take_next_, digits_);
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+// Copy the limbs of value_ to the lane_ of the interleaved limbs_, as 32-bit limbs
+template<size_t NbLanes>
+void scatter_to_lane(std::vector<uint32_t>& limbs_, size_t lane_, const large_unsigned_integer& value_) {
+    constexpr const size_t nb_parts = sizeof(large_unsigned_integer::underlying_type) / sizeof(uint32_t);
+
+    const auto& data = value_.get_data();
+    for (size_t index = 0; index < data.size(); ++index) {
+        for (size_t part = 0; part < nb_parts; ++part) {
+            limbs_[(index * nb_parts + part) * NbLanes + lane_] = static_cast<uint32_t>(data[index] >> (32 * part));
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Roots of values_, which are at most NbLanes
+template<size_t NbLanes>
+void compute_lockstep_group(std::span<const uint64_t> values_, size_t nb_fractional_digits_, std::span<std::string> digits_) {
+    assert(values_.size() <= NbLanes);
+
+    // The integral parts are short, they are computed by the scalar computers
+    std::array<details::square_root_next_digit_computer, NbLanes> computers;
+    std::array<bool, NbLanes> fractional_parts{};
+    bool any_fractional_part = false;
+    for (size_t lane = 0; lane < values_.size(); ++lane) {
+        auto& digits = digits_[lane];
+        auto integral_generator = details::compute_integral_part_of_square_root(values_[lane], computers[lane]);
+        while (integral_generator.has_value()) {
+            digits += to_char(integral_generator.value());
+        }
+
+        // There are no groups of digits in 0
+        if (digits.empty()) {
+            digits = "0";
+        }
+
+        // Perfect squares have no fractional part, and there is no decimal point without fractional digits
+        fractional_parts[lane] = computers[lane].has_next_digit() && nb_fractional_digits_ > 0;
+        if (fractional_parts[lane]) {
+            digits.reserve(digits.size() + 1 + nb_fractional_digits_);
+            digits += '.';
+            any_fractional_part = true;
+        }
+    }
+
+    if (!any_fractional_part) {
+        return;
+    }
+
+    details::square_root_lockstep_digit_computer<NbLanes> computer(computers);
+    std::array<unsigned int, NbLanes> lane_digits;
+    for (size_t index = 0; index < nb_fractional_digits_; ++index) {
+        computer(lane_digits);
+        for (size_t lane = 0; lane < values_.size(); ++lane) {
+            if (fractional_parts[lane]) {
+                digits_[lane] += to_char(lane_digits[lane]);
+            }
+        }
+    }
+}
+
+} // Anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace details {
+
+template<size_t NbLanes>
+square_root_lockstep_digit_computer<NbLanes>::square_root_lockstep_digit_computer(std::span<const square_root_next_digit_computer, NbLanes> computers_)
+    : step(next_lockstep_digit_scalar<NbLanes>) {
+#if defined(SQUARE_ROOT_HAS_SIMD_KERNELS)
+    switch (large_unsigned_integer::get_simd_kernel()) {
+    case large_unsigned_integer::simd_kernel::avx2:
+        step = next_lockstep_digit_avx2<NbLanes>;
+        break;
+    case large_unsigned_integer::simd_kernel::avx512:
+        step = next_lockstep_digit_avx512<NbLanes>;
+        break;
+    default:
+        break;
+    }
+#endif
+
+    // Leave a null top limb, the values grow by less than a limb per digit
+    constexpr const size_t nb_parts = sizeof(large_unsigned_integer::underlying_type) / sizeof(uint32_t);
+    for (const auto& computer : computers_) {
+        nb_limbs = std::max({ nb_limbs, computer.get_remainder().get_data().size() * nb_parts, computer.get_twenty_result().get_data().size() * nb_parts });
+    }
+    ++nb_limbs;
+
+    remainder.resize(nb_limbs * NbLanes);
+    next_remainder.resize(nb_limbs * NbLanes);
+    twenty_result.resize(nb_limbs * NbLanes);
+    for (size_t lane = 0; lane < NbLanes; ++lane) {
+        scatter_to_lane<NbLanes>(remainder, lane, computers_[lane].get_remainder());
+        scatter_to_lane<NbLanes>(twenty_result, lane, computers_[lane].get_twenty_result());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<size_t NbLanes>
+void square_root_lockstep_digit_computer<NbLanes>::operator()(std::span<unsigned int, NbLanes> digits_) {
+    step(remainder.data(), next_remainder.data(), twenty_result.data(), nb_limbs, take_next.data(), digits_.data());
+
+    // Add a limb when the top one of a lane is used, next_remainder is below remainder where it is taken
+    const size_t offset = (nb_limbs - 1) * NbLanes;
+    const bool grow = std::ranges::any_of(std::views::iota(offset, offset + NbLanes), [this](size_t index_) { return (remainder[index_] | twenty_result[index_]) != 0; });
+    if (grow) {
+        ++nb_limbs;
+        remainder.resize(nb_limbs * NbLanes);
+        next_remainder.resize(nb_limbs * NbLanes);
+        twenty_result.resize(nb_limbs * NbLanes);
+    }
+}
+
+template class square_root_lockstep_digit_computer<8>;
+template class square_root_lockstep_digit_computer<16>;
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::vector<std::string> compute_square_roots_in_lockstep(std::span<const uint64_t> values_, size_t nb_fractional_digits_) {
+    std::vector<std::string> digits(values_.size());
+
+    // One lane per 32-bit element of a vector register
+    const bool wide = large_unsigned_integer::get_simd_kernel() == large_unsigned_integer::simd_kernel::avx512;
+    const size_t nb_lanes = wide ? 16 : 8;
+    for (size_t index = 0; index < values_.size(); index += nb_lanes) {
+        const size_t nb_values = std::min(nb_lanes, values_.size() - index);
+        if (wide) {
+            compute_lockstep_group<16>(values_.subspan(index, nb_values), nb_fractional_digits_, std::span(digits).subspan(index, nb_values));
+        } else {
+            compute_lockstep_group<8>(values_.subspan(index, nb_values), nb_fractional_digits_, std::span(digits).subspan(index, nb_values));
+        }
+    }
+    return digits;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer power(large_unsigned_integer base_, size_t exponent_) {
+    large_unsigned_integer result{ 1u };
+    while (exponent_ > 0) {
+        if (exponent_ % 2 == 1) {
+            result = result * base_;
+        }
+
+        exponent_ /= 2;
+        if (exponent_ > 0) {
+            base_ = base_ * base_;
+        }
+    }
+    return result;
+}
+
+} // Anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace details {
+
+square_root_reciprocal_computer::square_root_reciprocal_computer(uint64_t value_, square_root_engine engine_)
+    : value(value_)
+    , engine(engine_)
+    , half_width((std::bit_width(value_) + 1) / 2) {
+    assert(value_ > 0);
+    assert(engine_ == square_root_engine::newton || engine_ == square_root_engine::goldschmidt);
+
+    // y = 2^(precision + half_width) / sqrt(value) is in [2^(precision - 1), 2^(precision + 1)]
+    constexpr const size_t seed_precision = 50;
+    const double seed = std::ldexp(1.0 / std::sqrt(static_cast<double>(value_)), static_cast<int>(seed_precision + half_width));
+    reciprocal = large_unsigned_integer(static_cast<uint64_t>(seed));
+    precision = seed_precision;
+
+    if (engine == square_root_engine::goldschmidt) {
+        half_reciprocal = reciprocal >> 1;
+        root = (large_unsigned_integer(value) * half_reciprocal) << 1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] large_unsigned_integer square_root_reciprocal_computer::operator()(size_t nb_fractional_digits_) {
+    // The result has half_width + nb_fractional_digits_ * log2(10) bits
+    constexpr const size_t guard_bits = 16;
+    refine(half_width + static_cast<size_t>(std::ceil(static_cast<double>(nb_fractional_digits_) * std::log2(10.0))) + guard_bits);
+
+    // sqrt(value) = value * y
+    const size_t scale = precision + half_width;
+    const auto ten_power = power(large_unsigned_integer(10u), nb_fractional_digits_);
+    const auto& scaled_root = engine == square_root_engine::newton ? large_unsigned_integer(value) * reciprocal : root;
+    auto result = (scaled_root * ten_power) >> scale;
+
+    // The truncated iterations may be off by a few units, (s + 1)^2 = s^2 + 2s + 1
+    const auto scaled_value = large_unsigned_integer(value) * ten_power * ten_power;
+    auto square = result * result;
+    while (square > scaled_value) {
+        square += 1u;
+        square -= result + result;
+        result -= large_unsigned_integer(1u);
+    }
+    for (auto next_square = square + result + result + 1u; next_square <= scaled_value; next_square += result + result + 1u) {
+        result += 1u;
+        square = next_square;
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+void square_root_reciprocal_computer::refine(size_t precision_) {
+    while (precision < precision_) {
+        const size_t next_precision = std::min(2 * precision, precision_);
+        const size_t shift = next_precision - precision;
+        precision = next_precision;
+
+        if (engine == square_root_engine::newton) {
+            reciprocal <<= shift;
+            newton_step();
+        } else {
+            // The steps keep x / h constant, so the rounding errors of the previous steps would
+            // bound the precision. x = 2 * value * h is restored from h first, a linear pass.
+            half_reciprocal <<= shift;
+            root = (large_unsigned_integer(value) * half_reciprocal) << 1;
+            goldschmidt_step();
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void square_root_reciprocal_computer::newton_step() {
+    const size_t scale = precision + half_width;
+
+    // value * y^2 ~ 2^scale
+    const auto value_y2 = (large_unsigned_integer(value) * (reciprocal * reciprocal)) >> scale;
+    const auto three = large_unsigned_integer(3u) << scale;
+    reciprocal = (reciprocal * (three - value_y2)) >> (scale + 1);
+}
+
+// ----------------------------------------------------------------------------
+
+void square_root_reciprocal_computer::goldschmidt_step() {
+    const size_t scale = precision + half_width;
+
+    // r = 1/2 - x * h is small, its sign is kept apart
+    const auto half = large_unsigned_integer(1u) << (scale - 1);
+    const auto product = (root * half_reciprocal) >> scale;
+    if (product <= half) {
+        const auto r = half - product;
+        root += (root * r) >> scale;
+        half_reciprocal += (half_reciprocal * r) >> scale;
+    } else {
+        const auto r = product - half;
+        root -= (root * r) >> scale;
+        half_reciprocal -= (half_reciprocal * r) >> scale;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+generator<char> compute_square_root_reciprocal_method(uint64_t value_, square_root_engine engine_) {
+    square_root_reciprocal_computer computer(value_, engine_);
+
+    const auto integral_part = computer(0);
+    for (char digit : to_string(integral_part)) {
+        co_yield digit;
+    }
+
+    // Early return optimization when the number is a perfect square
+    if (integral_part * integral_part == large_unsigned_integer(value_)) {
+        co_return;
+    }
+
+    co_yield '.';
+
+    // Every run computes the root again with twice as many digits, the previous ones are skipped
+    constexpr const size_t nb_first_digits = 64;
+    size_t nb_digits = 0;
+    for (size_t nb_next_digits = nb_first_digits;; nb_next_digits *= 2) {
+        const auto digits = to_string(computer(nb_next_digits));
+        for (char digit : std::string_view(digits).substr(digits.size() - nb_next_digits + nb_digits)) {
+            co_yield digit;
+        }
+        nb_digits = nb_next_digits;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::string compute_square_root_digits(const large_unsigned_integer& value_, size_t nb_fractional_digits_) {
+    const auto integral_part = isqrt(value_);
+
+    // Early return optimization when the number is a perfect square
+    if (integral_part * integral_part == value_) {
+        return to_string(integral_part);
+    }
+
+    // floor(sqrt(value * 10^(2N))) holds all the requested digits
+    const auto scaled_value = value_ * power(large_unsigned_integer(100u), nb_fractional_digits_);
+    auto digits = to_string(isqrt(scaled_value));
+
+    // There is no decimal point without fractional digits
+    assert(digits.size() > nb_fractional_digits_);
+    if (nb_fractional_digits_ > 0) {
+        digits.insert(digits.size() - nb_fractional_digits_, 1, '.');
+    }
+    return digits;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::string compute_square_root_digit_range(const large_unsigned_integer& value_, size_t offset_, size_t count_) {
+    if (count_ == 0) {
+        return {};
+    }
+
+    // The requested digits are the last count_ digits of floor(sqrt(value * 10^(2N))),
+    // only this window is converted to decimal
+    const auto scaled_value = value_ * power(large_unsigned_integer(100u), offset_ + count_);
+    const auto window = isqrt(scaled_value) % power(large_unsigned_integer(10u), count_);
+
+    auto digits = to_string(window);
+    assert(digits.size() <= count_);
+    digits.insert(0, count_ - digits.size(), '0');
+    return digits;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+void save_checkpoint(std::ostream& stream_, const square_root_checkpoint& checkpoint_) {
+    stream_.write(checkpoint_magic.data(), checkpoint_magic.size());
+    stream_.put(static_cast<char>(checkpoint_version));
+    stream_.put(static_cast<char>(sizeof(large_unsigned_integer::underlying_type)));
+    write_uint64(stream_, checkpoint_.value);
+    write_uint64(stream_, checkpoint_.nb_fractional_digits);
+    write_large_integer(stream_, checkpoint_.remainder);
+    write_large_integer(stream_, checkpoint_.twenty_result);
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] square_root_checkpoint load_checkpoint(std::istream& stream_) {
+    std::array<char, checkpoint_magic.size() + 2> header;
+    if (!stream_.read(header.data(), header.size()) || !std::ranges::equal(std::span(header).first(checkpoint_magic.size()), checkpoint_magic)) {
+        throw std::runtime_error("Invalid checkpoint");
+    }
+
+    const auto version = static_cast<uint8_t>(header[checkpoint_magic.size()]);
+    const auto limb_size = static_cast<size_t>(header[checkpoint_magic.size() + 1]);
+    if (version != checkpoint_version || (limb_size != 4 && limb_size != 8)) {
+        throw std::runtime_error("Unsupported checkpoint");
+    }
+
+    square_root_checkpoint checkpoint;
+    checkpoint.value = read_uint64(stream_);
+    checkpoint.nb_fractional_digits = read_uint64(stream_);
+    checkpoint.remainder = read_large_integer(stream_, limb_size);
+    checkpoint.twenty_result = read_large_integer(stream_, limb_size);
+    return checkpoint;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] square_root_checkpoint_policy make_file_checkpoint_policy(const std::filesystem::path& path_, size_t interval_) {
+    return { interval_, [path_](const square_root_checkpoint& checkpoint_) {
+        auto temporary_path = path_;
+        temporary_path += ".tmp";
+
+#if defined(__unix__)
+        std::ostringstream stream(std::ios::binary);
+        save_checkpoint(stream, checkpoint_);
+        write_file_durably(temporary_path, stream.view());
+        std::filesystem::rename(temporary_path, path_);
+        sync_directory(path_.has_parent_path() ? path_.parent_path() : std::filesystem::path("."));
+#else
+        {
+            std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+            save_checkpoint(stream, checkpoint_);
+            if (!stream.flush()) {
+                throw std::runtime_error("Cannot write checkpoint " + temporary_path.string());
+            }
+        }
+        std::filesystem::rename(temporary_path, path_);
+#endif
+    } };
+}
+
+// ----------------------------------------------------------------------------
+
+generator<char> resume_square_root_digit_by_digit_method(square_root_checkpoint checkpoint_, square_root_checkpoint_policy policy_, std::pmr::memory_resource* resource_) {
+    details::square_root_next_digit_computer computer(checkpoint_.remainder, checkpoint_.twenty_result, resource_);
+
+    auto fractional_generator = details::compute_fractional_part_of_square_root(computer, checkpoint_.value, checkpoint_.nb_fractional_digits, policy_);
+    while (fractional_generator.has_value()) {
+        co_yield fractional_generator.value();
+    }
+}
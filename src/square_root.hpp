@@ -2,39 +2,228 @@
 #define SQUARE_ROOT_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <cmath>
 #include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
 #include <optional>
+#include <ostream>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
 #include <stop_token>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "digit_sink.hpp"
 #include "generator.hpp"
 #include "large_unsigned_integer.hpp"
 #include "spsc_queue.hpp"
+#include "thread_pool.hpp"
 #include "utility.hpp"
 
+// ----------------------------------------------------------------------------
+// Engines available to compute the digits of the square root
+enum class square_root_engine {
+    digit_by_digit, // One decimal digit per step
+    block,          // A block of decimal digits per step (9 or 18 depending on the limb size)
+    newton,         // Newton iteration on the reciprocal square root, the digits come by doubling runs
+    goldschmidt,    // Goldschmidt iteration on the root and half its reciprocal, by doubling runs
+};
+
+// ----------------------------------------------------------------------------
+// Settings of the pipeline between the thread computing the digits and the sink
+struct digit_pipeline_options {
+    size_t chunk_size = 4096;                           // Largest number of digits per chunk
+    std::chrono::milliseconds latency{ 50 };            // Longest time a digit waits before being sent and flushed
+    size_t flush_size = 64 * 1024;                      // Bytes written between flushes while digits keep coming
+    size_t max_nb_queued_chunks = 256;                  // Chunks computed ahead of the sink before the producer waits
+};
+
+// ----------------------------------------------------------------------------
+// State of the digit by digit method after nb_fractional_digits digits of the fractional
+// part, it is enough to resume the stream without computing the previous digits again
+struct square_root_checkpoint {
+    uint64_t value = 0;
+    uint64_t nb_fractional_digits = 0;
+    large_unsigned_integer remainder;
+    large_unsigned_integer twenty_result;   // 20 * result
+
+    [[nodiscard]] bool operator==(const square_root_checkpoint&) const = default;
+};
+
+// Binary format: a header then the limbs of each large integer in little endian,
+// a checkpoint can be loaded with either limb size
+void save_checkpoint(std::ostream& stream_, const square_root_checkpoint& checkpoint_);
+[[nodiscard]] square_root_checkpoint load_checkpoint(std::istream& stream_);
+
+// Snapshots taken by the digit by digit method while it streams the fractional part
+struct square_root_checkpoint_policy {
+    size_t interval = 0;    // Fractional digits between two snapshots, 0 to disable them
+    std::function<void(const square_root_checkpoint&)> save;
+};
+
+// Save the snapshots to path_, the file is replaced atomically so that a crash never leaves a partial checkpoint
+[[nodiscard]] square_root_checkpoint_policy make_file_checkpoint_policy(const std::filesystem::path& path_, size_t interval_);
+
 // ----------------------------------------------------------------------------
 
 namespace details {
 
 // ----------------------------------------------------------------------------
 // Helper class to compute digits one at a time
+// The buffers are kept between digits and updated in place so that each digit
+// only costs a few linear passes without any allocation in the steady state
 class square_root_next_digit_computer {
 public:
-    [[nodiscard]] unsigned int operator()(auto current_);
+    // The buffers grow from resource_ (e.g. a huge_page_resource for very long streams)
+    explicit square_root_next_digit_computer(std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
+
+    // Restore the state of a previous computation
+    square_root_next_digit_computer(const large_unsigned_integer& remainder_, const large_unsigned_integer& twenty_result_, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
+
+    [[nodiscard]] unsigned int operator()(unsigned int current_);
     [[nodiscard]] bool has_next_digit() const;
 
+    [[nodiscard]] const large_unsigned_integer& get_remainder() const { return remainder; }
+    [[nodiscard]] const large_unsigned_integer& get_twenty_result() const { return twenty_result; }
+
 private:
-    large_unsigned_integer remainder{ 0u };
-    large_unsigned_integer result{ 0u };
+    void compute_trial(unsigned int x_);
+
+    large_unsigned_integer remainder;
+    large_unsigned_integer twenty_result;   // 20 * result
+    large_unsigned_integer trial;           // x * (twenty_result + x)
+    large_unsigned_integer next_trial;      // (x + 1) * (twenty_result + x + 1)
 };
 
+// ----------------------------------------------------------------------------
+// Helper class to compute a block of digits at a time, the computation is done
+// in base 10^nb_digits so that each step produces nb_digits decimal digits
+class square_root_next_block_computer {
+public:
+    using underlying_type = large_unsigned_integer::underlying_type;
+    using extended_type = large_unsigned_integer::extended_type;
+
+    // Largest number of decimal digits so that twice a block fits in an underlying_type
+    static constexpr const unsigned int nb_digits = [] {
+        unsigned int digits = 0;
+        for (underlying_type value{ 10 }; value <= std::numeric_limits<underlying_type>::max() / 2; value *= 10) {
+            ++digits;
+            if (value > std::numeric_limits<underlying_type>::max() / 10) {
+                break;
+            }
+        }
+        return digits;
+    }();
+    static constexpr const underlying_type block_base = [] {
+        underlying_type value{ 1 };
+        for (unsigned int i = 0; i < nb_digits; ++i) {
+            value *= 10;
+        }
+        return value;
+    }();
+
+    using buffer_type = std::array<char, nb_digits>;
+
+    explicit square_root_next_block_computer(std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
+
+    // Bring down a group of 2 * nb_digits decimal digits and compute the next block of the root
+    [[nodiscard]] underlying_type operator()(extended_type current_);
+    [[nodiscard]] bool has_next_digit() const;
+
+private:
+    [[nodiscard]] underlying_type estimate_next_block() const;
+    void compute_trial(underlying_type y_);
+
+    large_unsigned_integer remainder;
+    large_unsigned_integer twice_result;    // 2 * result * block_base
+    large_unsigned_integer trial;           // y * (twice_result + y)
+    large_unsigned_integer next_trial;      // (y + 1) * (twice_result + y + 1)
+};
+
+// ----------------------------------------------------------------------------
+// Helper class to compute the square root from its reciprocal in binary fixed point,
+// without any division. The newton engine iterates y = y * (3 - value * y^2) / 2 and
+// the goldschmidt engine the coupled x = x + x * r, h = h + h * r with r = 1/2 - x * h,
+// which converge to x = sqrt(value) and h = 1 / (2 * sqrt(value)). The iterations start
+// from a double precision seed, double the precision at each step, and are resumed from
+// the previous call when more digits are requested.
+class square_root_reciprocal_computer {
+public:
+    square_root_reciprocal_computer(uint64_t value_, square_root_engine engine_);
+
+    // floor(sqrt(value) * 10^nb_fractional_digits_), the last unit is checked exactly
+    [[nodiscard]] large_unsigned_integer operator()(size_t nb_fractional_digits_);
+
+private:
+    // Iterate until the relative precision is at least precision_ bits
+    void refine(size_t precision_);
+    void newton_step();
+    void goldschmidt_step();
+
+    uint64_t value;
+    square_root_engine engine;
+    size_t half_width;                          // Half the bit width of value, rounded up
+    size_t precision;                           // The fixed point scale is 2^(precision + half_width)
+    large_unsigned_integer reciprocal;          // y = scale / sqrt(value), newton engine
+    large_unsigned_integer root;                // x = scale * sqrt(value), goldschmidt engine
+    large_unsigned_integer half_reciprocal;     // h = scale / (2 * sqrt(value)), goldschmidt engine
+};
+
+// Digits of the square root by runs of doubling length, each run costs a few large multiplications
+generator<char> compute_square_root_reciprocal_method(uint64_t value_, square_root_engine engine_);
+
+// ----------------------------------------------------------------------------
+// Helper class to compute the fractional digits of NbLanes radicands in lockstep,
+// NbLanes is 8 or 16 to fill the vector registers of AVX2 or AVX-512.
+// The remainders and twenty_results of all the lanes are interleaved limb by limb,
+// so that each pass of the digit by digit method is a single vectorized loop over
+// the limbs for all the lanes instead of one loop per radicand.
+template<size_t NbLanes>
+class square_root_lockstep_digit_computer {
+public:
+    static_assert(NbLanes == 8 || NbLanes == 16);
+    static constexpr const size_t nb_lanes = NbLanes;
+
+    // Start from the state of one scalar computer per lane after the integral part,
+    // the instruction set is the one selected for large_unsigned_integer at that time
+    explicit square_root_lockstep_digit_computer(std::span<const square_root_next_digit_computer, NbLanes> computers_);
+
+    // Compute the next fractional digit of every lane
+    void operator()(std::span<unsigned int, NbLanes> digits_);
+
+private:
+    // Vectorized digit step of the selected instruction set
+    using step_type = void (*)(uint32_t*, uint32_t*, uint32_t*, size_t, uint64_t*, unsigned int*);
+    step_type step;
+
+    // Limb i of lane j is at i * NbLanes + j, the top limb of every lane is kept null
+    size_t nb_limbs = 0;
+    std::vector<uint32_t> remainder;
+    std::vector<uint32_t> next_remainder;       // remainder - (twenty_result + 2x + 1)
+    std::vector<uint32_t> twenty_result;        // 20 * result
+    std::array<uint64_t, NbLanes> take_next{};  // All ones in the lanes whose remainder is next_remainder
+};
+
+extern template class square_root_lockstep_digit_computer<8>;
+extern template class square_root_lockstep_digit_computer<16>;
+
+// ----------------------------------------------------------------------------
+
 [[nodiscard]] std::vector<unsigned int> split_integer_into_groups_of_2_digits(std::integral auto value_) {
     assert(value_ != NAN && value_ >= 0);
 
@@ -65,11 +254,67 @@ generator<unsigned int> compute_integral_part_of_square_root(std::integral auto
 
 generator<unsigned int> compute_fractional_part_of_square_root(square_root_next_digit_computer& computer_);
 
+// Fractional digits after the first nb_fractional_digits_ ones, with the snapshots of policy_
+generator<char> compute_fractional_part_of_square_root(square_root_next_digit_computer& computer_, uint64_t value_, uint64_t nb_fractional_digits_, const square_root_checkpoint_policy& policy_);
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::vector<large_unsigned_integer::extended_type> split_integer_into_groups_of_block_digits(std::integral auto value_) {
+    assert(value_ != NAN && value_ >= 0);
+
+    using extended_type = large_unsigned_integer::extended_type;
+    constexpr const extended_type group_base = extended_type{ square_root_next_block_computer::block_base } * square_root_next_block_computer::block_base;
+
+    std::vector<extended_type> integer_values;
+
+    auto residual = static_cast<extended_type>(value_);
+    while (residual > 0) {
+        integer_values.emplace_back(residual % group_base);
+        residual /= group_base;
+    }
+
+    return integer_values;
 }
 
 // ----------------------------------------------------------------------------
+// Write the decimal digits of a block, left padded with zeros up to width_
+[[nodiscard]] std::string_view block_to_chars(square_root_next_block_computer::buffer_type& buffer_, large_unsigned_integer::underlying_type block_, unsigned int width_);
 
-generator<char> compute_square_root_digit_by_digit_method(std::integral auto value_) {
+generator<char> compute_square_root_block_method(std::integral auto value_, std::pmr::memory_resource* resource_) {
+    square_root_next_block_computer computer(resource_);
+    square_root_next_block_computer::buffer_type buffer;
+
+    // Only the leading block is not padded
+    unsigned int width = 0;
+    const auto integer_values = split_integer_into_groups_of_block_digits(value_);
+    for (auto group : std::views::reverse(integer_values)) {
+        for (char digit : block_to_chars(buffer, computer(group), width)) {
+            co_yield digit;
+        }
+        width = square_root_next_block_computer::nb_digits;
+    }
+
+    // Early return optimization when the number is a perfect square
+    if (!computer.has_next_digit()) {
+        co_return;
+    }
+
+    co_yield '.';
+
+    while (computer.has_next_digit()) {
+        for (char digit : block_to_chars(buffer, computer(0), square_root_next_block_computer::nb_digits)) {
+            co_yield digit;
+        }
+    }
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+// The buffers of the computation are allocated from resource_
+template<square_root_engine engine = square_root_engine::digit_by_digit>
+generator<char> compute_square_root_digit_by_digit_method(std::integral auto value_, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource()) {
     assert(value_ != NAN && value_ >= 0);
 
     // Early return optimization
@@ -78,7 +323,24 @@ generator<char> compute_square_root_digit_by_digit_method(std::integral auto val
         co_return;
     }
 
-    details::square_root_next_digit_computer computer;
+    if constexpr (engine == square_root_engine::block) {
+        auto block_generator = details::compute_square_root_block_method(value_, resource_);
+        while (block_generator.has_value()) {
+            co_yield block_generator.value();
+        }
+        co_return;
+    }
+
+    // The iterations allocate their own temporaries, resource_ is not used
+    if constexpr (engine == square_root_engine::newton || engine == square_root_engine::goldschmidt) {
+        auto reciprocal_generator = details::compute_square_root_reciprocal_method(static_cast<uint64_t>(value_), engine);
+        while (reciprocal_generator.has_value()) {
+            co_yield reciprocal_generator.value();
+        }
+        co_return;
+    }
+
+    details::square_root_next_digit_computer computer(resource_);
 
     auto integral_generator = details::compute_integral_part_of_square_root(value_, computer);
     while (integral_generator.has_value()) {
@@ -100,38 +362,286 @@ generator<char> compute_square_root_digit_by_digit_method(std::integral auto val
 }
 
 // ----------------------------------------------------------------------------
-// Stream the value of the square root one (decimal) digit at a time
-void compute_square_root_digit_by_digit_method(std::ostream& stream_, std::integral auto value_, std::stop_token stop_) {
-    // NaN is a special case
-    if (value_ == NAN) { // std::isfinite with integer is not mandatory in the standard
-        stream_ << NAN;
-        return;
+// Same digits as compute_square_root_digit_by_digit_method, with the snapshots of policy_
+generator<char> compute_square_root_digit_by_digit_method(std::integral auto value_, square_root_checkpoint_policy policy_, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource()) {
+    assert(value_ != NAN && value_ >= 0);
+
+    // Early return optimization
+    if (value_ == 0 || value_ == 1) {
+        co_yield to_char(value_);
+        co_return;
+    }
+
+    details::square_root_next_digit_computer computer(resource_);
+
+    auto integral_generator = details::compute_integral_part_of_square_root(value_, computer);
+    while (integral_generator.has_value()) {
+        co_yield to_char(integral_generator.value());
+    }
+
+    // Early return optimization when the number is a perfect square
+    if (!computer.has_next_digit()) {
+        co_return;
+    }
+
+    co_yield '.';
+
+    auto fractional_generator = details::compute_fractional_part_of_square_root(computer, static_cast<uint64_t>(value_), 0, policy_);
+    while (fractional_generator.has_value()) {
+        co_yield fractional_generator.value();
     }
+}
+
+// Continue the stream of a checkpoint from its next fractional digit, in O(size of the checkpoint)
+generator<char> resume_square_root_digit_by_digit_method(square_root_checkpoint checkpoint_, square_root_checkpoint_policy policy_ = {}, std::pmr::memory_resource* resource_ = std::pmr::get_default_resource());
+
+namespace details {
+
+// Compute the integral part and nb_fractional_digits_ of the square root
+[[nodiscard]] std::string compute_square_root_digits(const large_unsigned_integer& value_, size_t nb_fractional_digits_);
 
+// Fractional digits [offset_, offset_ + count_) of the square root
+[[nodiscard]] std::string compute_square_root_digit_range(const large_unsigned_integer& value_, size_t offset_, size_t count_);
+
+}
+
+// ----------------------------------------------------------------------------
+// Compute the square root with nb_fractional_digits_ at once, the result is the
+// same as the first digits of compute_square_root_digit_by_digit_method but the
+// cost is dominated by a few large multiplications instead of O(N^2) digit steps
+[[nodiscard]] std::string compute_square_root_digits(std::integral auto value_, size_t nb_fractional_digits_) {
     // Cannot calculate the root of a negative number
     if (value_ < 0) {
-        stream_ << NAN;
+        return "nan";
+    }
+
+    return details::compute_square_root_digits(large_unsigned_integer(static_cast<std::make_unsigned_t<decltype(value_)>>(value_)), nb_fractional_digits_);
+}
+
+// ----------------------------------------------------------------------------
+// Fractional digits [offset_, offset_ + count_) of the square root (the first digit after the
+// decimal point has offset 0), the root is computed in bulk and only the requested window is
+// converted to decimal. Perfect squares have an infinite sequence of zeros.
+[[nodiscard]] std::string compute_square_root_digit_range(std::integral auto value_, size_t offset_, size_t count_) {
+    // Cannot calculate the root of a negative number
+    if (value_ < 0) {
+        return "nan";
+    }
+
+    return details::compute_square_root_digit_range(large_unsigned_integer(static_cast<std::make_unsigned_t<decltype(value_)>>(value_)), offset_, count_);
+}
+
+namespace details {
+
+[[nodiscard]] std::vector<std::string> compute_square_roots_in_lockstep(std::span<const uint64_t> values_, size_t nb_fractional_digits_);
+
+}
+
+// ----------------------------------------------------------------------------
+// Same result as compute_square_root_digits for each value, the fractional digits of
+// 8 or 16 radicands (AVX2 or AVX-512) are computed in lockstep by the digit by digit
+// method. It removes the per radicand overhead of many short roots, up to a few
+// thousand digits, where the bulk method is dominated by its fixed costs.
+template<std::integral T>
+[[nodiscard]] std::vector<std::string> compute_square_roots_in_lockstep(std::span<const T> values_, size_t nb_fractional_digits_) {
+    // The lanes of the negative radicands compute the root of 0
+    std::vector<uint64_t> values(values_.size());
+    std::ranges::transform(values_, values.begin(), [](T value_) { return value_ < 0 ? uint64_t{ 0 } : static_cast<uint64_t>(value_); });
+
+    auto digits = details::compute_square_roots_in_lockstep(values, nb_fractional_digits_);
+    for (size_t index = 0; index < values_.size(); ++index) {
+        // Cannot calculate the root of a negative number
+        if (values_[index] < 0) {
+            digits[index] = "nan";
+        }
+    }
+    return digits;
+}
+
+// ----------------------------------------------------------------------------
+// Aggregated throughput of a batch of square roots
+struct square_root_batch_statistics {
+    size_t nb_radicands = 0;
+    size_t nb_perfect_squares = 0;
+    size_t nb_characters = 0;           // Written to the sinks
+    size_t nb_threads = 0;
+    size_t nb_stolen_tasks = 0;         // Tasks balanced from a thread to another
+    std::chrono::nanoseconds elapsed{};
+
+    [[nodiscard]] double get_characters_per_second() const {
+        return elapsed.count() == 0 ? 0.0 : static_cast<double>(nb_characters) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+namespace details {
+
+[[nodiscard]] bool is_perfect_square(std::integral auto value_) {
+    if (value_ < 0) {
+        return false;
+    }
+
+    // The floating point estimate is off by at most one unit
+    const auto value = static_cast<uint64_t>(value_);
+    auto root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+    while (root > 0 && (root > std::numeric_limits<uint32_t>::max() || root * root > value)) {
+        --root;
+    }
+    while (root < std::numeric_limits<uint32_t>::max() && (root + 1) * (root + 1) <= value) {
+        ++root;
+    }
+    return root * root == value;
+}
+
+}
+
+// Compute the square roots of values_ with nb_fractional_digits_ each on the threads of pool_,
+// the digits of values_[i] are written to sinks_[i] and the sinks are flushed when done.
+// The expensive irrational roots are scheduled before the perfect squares, the pool balances the rest.
+// Batches may run concurrently on the same pool, or from a task of the pool.
+template<std::integral T, digit_sink Sink>
+square_root_batch_statistics compute_square_roots(thread_pool& pool_, std::span<const T> values_, size_t nb_fractional_digits_, std::span<Sink> sinks_) {
+    assert(values_.size() == sinks_.size());
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<size_t> order(values_.size());
+    std::iota(order.begin(), order.end(), size_t{ 0 });
+    std::vector<bool> perfect_squares(values_.size());
+    for (size_t index = 0; index < values_.size(); ++index) {
+        perfect_squares[index] = details::is_perfect_square(values_[index]);
+    }
+    std::ranges::stable_partition(order, [&](size_t index_) { return !perfect_squares[index_]; });
+
+    // The first tasks are run first on every thread of the pool, the batch is waited for on its own
+    thread_pool::task_group tasks(pool_);
+    std::atomic_size_t nb_characters{ 0 };
+    for (const size_t index : order | std::views::reverse) {
+        tasks.submit([&, index]() {
+            const std::array<digit_chunk, 1> digits{ compute_square_root_digits(values_[index], nb_fractional_digits_) };
+            sinks_[index].write(digits);
+            sinks_[index].flush();
+            nb_characters.fetch_add(digits[0].size(), std::memory_order_relaxed);
+        });
+    }
+    tasks.wait();
+
+    return {
+        values_.size(),
+        static_cast<size_t>(std::ranges::count(perfect_squares, true)),
+        nb_characters.load(std::memory_order_relaxed),
+        pool_.get_nb_threads(),
+        tasks.get_nb_stolen_tasks(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start),
+    };
+}
+
+// Same on the default pool, which has one thread per core
+template<std::integral T, digit_sink Sink>
+square_root_batch_statistics compute_square_roots(std::span<const T> values_, size_t nb_fractional_digits_, std::span<Sink> sinks_) {
+    return compute_square_roots(thread_pool::get_default(), values_, nb_fractional_digits_, sinks_);
+}
+
+// ----------------------------------------------------------------------------
+// Stream the value of the square root to sink_, the digits are computed by another
+// thread and sent by chunks so that the sink only writes and flushes once per chunk
+template<square_root_engine engine = square_root_engine::digit_by_digit>
+void compute_square_root_digit_by_digit_method(digit_sink auto& sink_, std::integral auto value_, std::stop_token stop_, digit_pipeline_options options_ = {}) {
+    using clock = std::chrono::steady_clock;
+
+    // Cannot calculate the root of a negative number
+    if (value_ < 0) {
+        const std::array<digit_chunk, 1> nan{ "nan" };
+        sink_.write(nan);
+        sink_.flush();
         return;
     }
 
-    spsc_queue<char> queue;
+    const size_t chunk_size = std::max(options_.chunk_size, size_t{ 1 });
+
+    // The producer waits for the sink once max_nb_queued_chunks chunks are pending
+    constexpr size_t segment_capacity = 64;
+    spsc_queue<digit_chunk> queue(segment_capacity, std::max(options_.max_nb_queued_chunks, segment_capacity) * sizeof(digit_chunk));
     std::stop_source producer_stop_source;
-    std::jthread producer([&queue, value_, stop_, &producer_stop_source]() {
-        auto generator = compute_square_root_digit_by_digit_method(value_);
-        while (!stop_.stop_requested() && generator.has_value()) {
-            queue.emplace(generator.value());
+    std::jthread producer([&queue, value_, stop_, &producer_stop_source, &options_, chunk_size](std::stop_token thread_stop_) {
+        // Stop on a request of the caller, or of the jthread when the consumer leaves with an exception
+        std::stop_source stop_source;
+        const auto request_stop = [&stop_source]() { stop_source.request_stop(); };
+        std::stop_callback caller_stop(stop_, request_stop);
+        std::stop_callback thread_stop(thread_stop_, request_stop);
+        const auto stop = stop_source.get_token();
+
+        auto generator = compute_square_root_digit_by_digit_method<engine>(value_);
+
+        digit_chunk chunk;
+        chunk.reserve(chunk_size);
+        auto deadline = clock::now() + options_.latency;
+        while (!stop.stop_requested() && generator.has_value()) {
+            chunk.push_back(generator.value());
+
+            // A chunk is sent when full or when its first digit has waited too long
+            if (chunk.size() == chunk_size || clock::now() >= deadline) {
+                if (!queue.emplace(stop, std::exchange(chunk, digit_chunk()))) {
+                    break;
+                }
+                chunk.reserve(chunk_size);
+                deadline = clock::now() + options_.latency;
+            }
         }
 
+        if (!chunk.empty()) {
+            std::ignore = queue.emplace(stop, std::move(chunk));
+        }
         producer_stop_source.request_stop();
     });
 
+    // Every chunk already available is written at once, the sink is flushed when the consumer
+    // caught up with the producer or when the latency or size budget is exceeded
+    constexpr size_t max_batch_size = 16;
+    std::vector<digit_chunk> batch;
+    size_t nb_unflushed_bytes = 0;
+    auto last_flush = clock::now();
+
     auto producer_stop = producer_stop_source.get_token();
-    while (!producer_stop.stop_requested()) {
-        auto digit = queue.pop(producer_stop);
-        if (digit.has_value()) {
-            stream_ << digit.value() << std::flush; // Flush stream everytime for smoother display
+    while (auto chunk = queue.pop(producer_stop)) {
+        batch.clear();
+        batch.emplace_back(std::move(chunk.value()));
+        while (batch.size() < max_batch_size && !queue.empty()) {
+            batch.emplace_back(queue.pop());
+        }
+
+        sink_.write(batch);
+        for (const auto& written_chunk : batch) {
+            nb_unflushed_bytes += written_chunk.size();
+        }
+
+        const auto now = clock::now();
+        if (queue.empty() || nb_unflushed_bytes >= options_.flush_size || now - last_flush >= options_.latency) {
+            sink_.flush();
+            nb_unflushed_bytes = 0;
+            last_flush = now;
         }
     }
+
+    sink_.flush();
+}
+
+// ----------------------------------------------------------------------------
+// Stream the value of the square root to stream_
+template<square_root_engine engine = square_root_engine::digit_by_digit>
+void compute_square_root_digit_by_digit_method(std::ostream& stream_, std::integral auto value_, std::stop_token stop_, digit_pipeline_options options_ = {}) {
+    // NaN is a special case
+    if (value_ == NAN) { // std::isfinite with integer is not mandatory in the standard
+        stream_ << NAN;
+        return;
+    }
+
+    // Cannot calculate the root of a negative number
+    if (value_ < 0) {
+        stream_ << NAN;
+        return;
+    }
+
+    ostream_digit_sink sink(stream_);
+    compute_square_root_digit_by_digit_method<engine>(sink, value_, stop_, options_);
 }
 
 #endif // SQUARE_ROOT_HPP
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "square_root_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "square_root.hpp"
+
+// ----------------------------------------------------------------------------
+// Digits of one radicand, the fractional digits are packed in fixed-size blocks that
+// never move once allocated so that the readers can use them without any lock
+class square_root_cache::entry {
+public:
+    static constexpr size_t block_size = 16384;                     // Bytes
+    static constexpr size_t nb_block_digits = 2 * block_size;
+    static constexpr size_t nb_batch_digits = 256;                  // Digits computed at once by the stream extending the prefix
+
+    entry(square_root_cache& cache_, uint64_t value_)
+        : cache(cache_) {
+        auto integral_generator = details::compute_integral_part_of_square_root(value_, computer);
+        while (integral_generator.has_value()) {
+            integral_part += to_char(integral_generator.value());
+        }
+
+        // There are no groups of digits in 0
+        if (integral_part.empty()) {
+            integral_part = "0";
+        }
+
+        fractional_part = computer.has_next_digit();
+        finished = !fractional_part;
+    }
+
+    entry(const entry&) = delete;
+    entry& operator=(const entry&) = delete;
+
+    // The blocks stay counted in the memory usage of the cache until the last stream of the entry ends
+    ~entry() {
+        cache.on_entry_released(*this);
+    }
+
+    [[nodiscard]] const std::string& get_integral_part() const { return integral_part; }
+    [[nodiscard]] bool has_fractional_part() const { return fractional_part; }
+
+    // Number of fractional digits published, it is larger than index_ unless the expansion ended before
+    [[nodiscard]] size_t wait_for_digit(size_t index_) {
+        size_t nb_published_digits = nb_digits.load(std::memory_order_acquire);
+        if (index_ < nb_published_digits) {
+            return nb_published_digits;
+        }
+
+        // Only one stream extends the prefix, the others wait for it on the lock
+        std::lock_guard lock(extend_mutex);
+        nb_published_digits = nb_digits.load(std::memory_order_relaxed);
+        if (index_ < nb_published_digits || finished) {
+            return nb_published_digits;
+        }
+
+        extend();
+        return nb_digits.load(std::memory_order_relaxed);
+    }
+
+    // The digit must have been published
+    [[nodiscard]] char get_digit(size_t index_) const {
+        const size_t block_index = index_ / nb_block_digits;
+        const auto* published_table = tables[block_index / nb_table_blocks].load(std::memory_order_acquire);
+        const auto* published_block = (*published_table)[block_index % nb_table_blocks].load(std::memory_order_acquire);
+        const uint8_t byte = published_block[(index_ % nb_block_digits) / 2];
+        return to_char(index_ % 2 == 0 ? byte & 0x0F : byte >> 4);
+    }
+
+    // Guarded by the mutex of the cache
+    uint64_t last_used = 0;
+    size_t memory = 0;
+
+private:
+    using block = std::array<uint8_t, block_size>;
+
+    // Two-level directory of the blocks, sized up front so that adding a block only publishes
+    // its address: up to 2^20 blocks, i.e. more than 3 * 10^10 digits per radicand
+    static constexpr size_t nb_table_blocks = 4096;
+    static constexpr size_t nb_tables = 256;
+    using table = std::array<std::atomic<const uint8_t*>, nb_table_blocks>;
+
+    // Compute and publish the next batch of digits, every byte is complete when it is published
+    // as the number of digits stays even until the last digit of a finite expansion
+    void extend() {
+        std::array<uint8_t, nb_batch_digits> batch;
+        size_t nb_batch = 0;
+        while (nb_batch < batch.size() && computer.has_next_digit()) {
+            constexpr const unsigned int next_value = 0;
+            batch[nb_batch++] = static_cast<uint8_t>(computer(next_value));
+        }
+
+        const size_t nb_published_digits = nb_digits.load(std::memory_order_relaxed);
+        for (size_t index = 0; index < nb_batch; index += 2) {
+            const uint8_t high = index + 1 < nb_batch ? batch[index + 1] : 0;
+            get_byte(nb_published_digits + index) = static_cast<uint8_t>(batch[index] | (high << 4));
+        }
+
+        nb_digits.store(nb_published_digits + nb_batch, std::memory_order_release);
+        finished = !computer.has_next_digit();
+    }
+
+    // Byte holding the digit index_, a block is added when needed
+    [[nodiscard]] uint8_t& get_byte(size_t index_) {
+        const size_t block_index = index_ / nb_block_digits;
+        if (block_index == blocks.size()) {
+            if (block_index == nb_tables * nb_table_blocks) {
+                throw std::length_error("Too many digits in the square root cache");
+            }
+
+            auto& new_block = blocks.emplace_back(std::make_unique<block>());
+            new_block->fill(0);
+
+            const size_t table_index = block_index / nb_table_blocks;
+            if (table_index == owned_tables.size()) {
+                tables[table_index].store(owned_tables.emplace_back(std::make_unique<table>()).get(), std::memory_order_release);
+            }
+            (*owned_tables[table_index])[block_index % nb_table_blocks].store(new_block->data(), std::memory_order_release);
+
+            cache.on_block_allocated(*this, block_size);
+        }
+
+        return (*blocks[block_index])[(index_ % nb_block_digits) / 2];
+    }
+
+    square_root_cache& cache;
+    std::string integral_part;
+    bool fractional_part = false;
+
+    // Published prefix, read without lock
+    std::atomic_size_t nb_digits{ 0 };
+    std::array<std::atomic<const table*>, nb_tables> tables{};
+
+    // Frontier, guarded by extend_mutex
+    std::mutex extend_mutex;
+    details::square_root_next_digit_computer computer;
+    bool finished = false;
+    std::vector<std::unique_ptr<block>> blocks;
+    std::vector<std::unique_ptr<table>> owned_tables;
+};
+
+// ----------------------------------------------------------------------------
+
+square_root_cache::square_root_cache(size_t memory_budget_)
+    : memory_budget(memory_budget_) {}
+
+// ----------------------------------------------------------------------------
+
+square_root_cache::~square_root_cache() {
+    // The entries still use the mutex and the memory usage when they are released
+    entries.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] square_root_cache& square_root_cache::get_instance() {
+    static square_root_cache instance;
+    return instance;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] generator<char> square_root_cache::stream(uint64_t value_) {
+    const auto cached_entry = get_entry(value_);
+
+    for (char digit : cached_entry->get_integral_part()) {
+        co_yield digit;
+    }
+
+    // Early return optimization when the number is a perfect square
+    if (!cached_entry->has_fractional_part()) {
+        co_return;
+    }
+
+    co_yield '.';
+
+    size_t nb_available_digits = 0;
+    for (size_t index = 0;; ++index) {
+        if (index >= nb_available_digits) {
+            nb_available_digits = cached_entry->wait_for_digit(index);
+            if (index >= nb_available_digits) {
+                co_return;
+            }
+        }
+
+        co_yield cached_entry->get_digit(index);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] size_t square_root_cache::get_memory_usage() const {
+    std::lock_guard lock(mutex);
+    return memory_usage;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] size_t square_root_cache::get_nb_entries() const {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] std::shared_ptr<square_root_cache::entry> square_root_cache::get_entry(uint64_t value_) {
+    std::lock_guard lock(mutex);
+
+    auto& cached_entry = entries[value_];
+    if (cached_entry == nullptr) {
+        cached_entry = std::make_shared<entry>(*this, value_);
+    }
+
+    cached_entry->last_used = ++tick;
+    return cached_entry;
+}
+
+// ----------------------------------------------------------------------------
+
+void square_root_cache::on_block_allocated(entry& entry_, size_t nb_bytes_) {
+    // The evicted entries are released once the lock is released
+    std::vector<std::shared_ptr<entry>> evicted_entries;
+    std::lock_guard lock(mutex);
+
+    entry_.memory += nb_bytes_;
+    memory_usage += nb_bytes_;
+
+    // Evict the least recently streamed radicands, possibly entry_ itself. The digits of an
+    // evicted radicand are only freed with its last stream, they stay counted until then.
+    size_t remaining_memory = memory_usage;
+    while (remaining_memory > memory_budget && !entries.empty()) {
+        const auto oldest = std::ranges::min_element(entries, {}, [](const auto& pair_) { return pair_.second->last_used; });
+        if (oldest->second.use_count() == 1) {
+            remaining_memory -= oldest->second->memory;
+        }
+        evicted_entries.push_back(std::move(oldest->second));
+        entries.erase(oldest);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void square_root_cache::on_entry_released(entry& entry_) {
+    std::lock_guard lock(mutex);
+    memory_usage -= entry_.memory;
+}
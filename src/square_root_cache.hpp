@@ -0,0 +1,59 @@
+#ifndef SQUARE_ROOT_CACHE_HPP
+#define SQUARE_ROOT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "generator.hpp"
+
+// ----------------------------------------------------------------------------
+// Process-wide cache of the digits of square roots, shared by all the streams of the
+// same radicand. The fractional digits are stored packed 2 per byte and the published
+// prefix is read without any lock. A stream that reaches the end of the prefix extends
+// it with the cached digit computer, while the other streams of the radicand wait for it.
+// When the packed digits exceed the memory budget, the least recently streamed radicands
+// are evicted; their digits are released once their last stream ends, and are counted
+// in the memory usage until then.
+// The cache must outlive the streams created from it.
+class square_root_cache {
+public:
+    static constexpr size_t DefaultMemoryBudget = size_t{ 64 } << 20;
+
+    explicit square_root_cache(size_t memory_budget_ = DefaultMemoryBudget);
+    ~square_root_cache();
+
+    square_root_cache(const square_root_cache&) = delete;
+    square_root_cache& operator=(const square_root_cache&) = delete;
+
+    [[nodiscard]] static square_root_cache& get_instance();
+
+    // Same digits as compute_square_root_digit_by_digit_method
+    [[nodiscard]] generator<char> stream(uint64_t value_);
+
+    // Bytes of packed digits held, including the evicted radicands that are still streamed
+    [[nodiscard]] size_t get_memory_usage() const;
+    [[nodiscard]] size_t get_nb_entries() const;
+
+private:
+    class entry;
+
+    [[nodiscard]] std::shared_ptr<entry> get_entry(uint64_t value_);
+
+    // Account a new block of entry_, evicting radicands if the budget is exceeded
+    void on_block_allocated(entry& entry_, size_t nb_bytes_);
+
+    // Stop counting the blocks of entry_, which is destroyed
+    void on_entry_released(entry& entry_);
+
+    size_t memory_budget;
+
+    mutable std::mutex mutex;
+    std::map<uint64_t, std::shared_ptr<entry>> entries;
+    size_t memory_usage = 0;
+    uint64_t tick = 0;
+};
+
+#endif // SQUARE_ROOT_CACHE_HPP
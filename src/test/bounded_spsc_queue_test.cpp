@@ -0,0 +1,92 @@
+#include "../bounded_spsc_queue.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Bounded single producer single consumer queue") {
+    SECTION("Capacity is rounded up to a power of two") {
+        CHECK(bounded_spsc_queue<int>(0).capacity() == 1);
+        CHECK(bounded_spsc_queue<int>(5).capacity() == 8);
+        CHECK(bounded_spsc_queue<int>(8).capacity() == 8);
+    }
+
+    SECTION("Empty on construction") {
+        bounded_spsc_queue<int> queue;
+        CHECK(queue.empty());
+        CHECK(!queue.try_pop().has_value());
+    }
+
+    SECTION("Push fails when the queue is full") {
+        bounded_spsc_queue<int> queue(2);
+        CHECK(queue.try_push(1));
+        CHECK(queue.try_push(2));
+        CHECK(!queue.try_push(3));
+        CHECK(queue.size() == 2);
+
+        CHECK(queue.try_pop() == 1);
+        CHECK(queue.try_push(3));
+        CHECK(queue.try_pop() == 2);
+        CHECK(queue.try_pop() == 3);
+        CHECK(queue.empty());
+    }
+
+    SECTION("Batches wrap around the end of the buffer") {
+        bounded_spsc_queue<int> queue(4);
+        const std::array<int, 3> first{ 1, 2, 3 };
+        const std::array<int, 5> second{ 4, 5, 6, 7, 8 };
+
+        CHECK(queue.try_push_n(first) == 3);
+        std::array<int, 2> popped{};
+        CHECK(queue.try_pop_n(popped) == 2);
+        CHECK(popped == std::array<int, 2>{ 1, 2 });
+
+        // Only 3 free slots, 2 of them at the beginning of the buffer
+        CHECK(queue.try_push_n(second) == 3);
+
+        std::array<int, 8> remaining{};
+        CHECK(queue.try_pop_n(remaining) == 4);
+        CHECK(std::ranges::equal(std::span(remaining).first(4), std::array{ 3, 4, 5, 6 }));
+        CHECK(queue.try_pop_n(remaining) == 0);
+    }
+
+    SECTION("Values are popped in the same order in multithreaded context") {
+        constexpr size_t nb_data = 100000;
+        bounded_spsc_queue<int> queue(64);
+
+        std::jthread producer([&]() {
+            std::vector<int> values(nb_data);
+            std::iota(values.begin(), values.end(), 0);
+
+            // Alternate batches and single values
+            std::span<const int> pending(values);
+            while (!pending.empty()) {
+                const size_t nb_pushed = pending.size() % 2 == 0 ? queue.try_push_n(pending.first(std::min<size_t>(pending.size(), 37))) : queue.try_push(pending.front());
+                pending = pending.subspan(nb_pushed);
+                if (nb_pushed == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        std::vector<int> result;
+        result.reserve(nb_data);
+        std::array<int, 29> buffer{};
+        while (result.size() < nb_data) {
+            const size_t nb_popped = queue.try_pop_n(buffer);
+            result.insert(result.end(), buffer.begin(), buffer.begin() + nb_popped);
+            if (nb_popped == 0) {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        std::vector<int> expected(nb_data);
+        std::iota(expected.begin(), expected.end(), 0);
+        CHECK(result == expected);
+    }
+}
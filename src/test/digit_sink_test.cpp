@@ -0,0 +1,68 @@
+#include "../digit_sink.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+
+TEST_CASE("Digit sinks") {
+    using namespace std::string_literals;
+
+    SECTION("Stream sink writes the chunks in order") {
+        std::ostringstream stream;
+        ostream_digit_sink sink(stream);
+        const std::array<digit_chunk, 3> chunks{ "1.4142"s, ""s, "135623"s };
+        sink.write(chunks);
+        sink.flush();
+
+        CHECK(stream.str() == "1.4142135623"s);
+    }
+
+#if defined(__unix__)
+    SECTION("File descriptor sink writes the whole batches") {
+        std::FILE* file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        file_descriptor_digit_sink sink(fileno(file));
+        const std::array<digit_chunk, 3> chunks{ "1.4142"s, ""s, "135623"s };
+        sink.write(chunks);
+        sink.flush();
+
+        std::array<char, 16> buffer{};
+        std::rewind(file);
+        CHECK(std::string(buffer.data(), std::fread(buffer.data(), 1, buffer.size(), file)) == "1.4142135623"s);
+        std::fclose(file);
+    }
+
+    SECTION("Mapped file sink grows by extents and is trimmed when closed") {
+        // Unique name, so that concurrent runs do not truncate the mapped file of each other
+        const auto path = std::filesystem::temp_directory_path() / ("mapped_file_digit_sink_test_" + std::to_string(std::random_device{}()) + ".txt");
+
+        // Chunks crossing several one page extents
+        std::string expected;
+        {
+            mapped_file_digit_sink sink(path, { .extent_size = 1, .sync_interval = 5000 });
+            for (int index = 0; index < 100; ++index) {
+                const std::array<digit_chunk, 2> chunks{ std::string(97, static_cast<char>('0' + index % 10)), "."s };
+                sink.write(chunks);
+                expected += chunks[0] + chunks[1];
+            }
+            sink.sync();
+            CHECK(sink.get_size() == expected.size());
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        const std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        CHECK(std::filesystem::file_size(path) == expected.size());
+        CHECK(content == expected);
+
+        file.close();
+        std::filesystem::remove(path);
+    }
+#endif
+}
@@ -0,0 +1,34 @@
+#include "../huge_page_resource.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+TEST_CASE("Huge page memory resource") {
+    SECTION("Large blocks are aligned on huge pages") {
+        huge_page_resource resource;
+        const size_t size = 3 * huge_page_resource::huge_page_size + 1;
+        void* pointer = resource.allocate(size, alignof(std::uint64_t));
+
+        CHECK(reinterpret_cast<std::uintptr_t>(pointer) % huge_page_resource::huge_page_size == 0);
+        std::memset(pointer, 0xFF, size);
+        resource.deallocate(pointer, size, alignof(std::uint64_t));
+    }
+
+    SECTION("Small blocks are forwarded to upstream") {
+        std::pmr::monotonic_buffer_resource upstream;
+        huge_page_resource resource(1024, &upstream);
+        void* pointer = resource.allocate(16, 8);
+
+        CHECK(pointer != nullptr);
+        resource.deallocate(pointer, 16, 8);
+    }
+
+    SECTION("Resources are only equal to themselves") {
+        huge_page_resource lhs;
+        huge_page_resource rhs;
+        CHECK(lhs == lhs);
+        CHECK(lhs != rhs);
+    }
+}
@@ -1,9 +1,29 @@
 #include "../large_unsigned_integer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
+#include <random>
+#include <stdexcept>
+#include <ranges>
+#include <string_view>
 
 #include <catch2/catch_test_macros.hpp>
 
+namespace {
+
+// Limbs drawn uniformly from engine_
+large_unsigned_integer::collection_type make_random(std::mt19937& engine_, size_t size_) {
+    std::uniform_int_distribution<large_unsigned_integer::underlying_type> distribution;
+    large_unsigned_integer::collection_type data(size_);
+    std::ranges::generate(data, [&] { return distribution(engine_); });
+    return data;
+}
+
+}
+
 TEST_CASE("large_unsigned_integer") {
     using namespace std::string_literals;
 
@@ -45,4 +65,308 @@ TEST_CASE("large_unsigned_integer") {
         CHECK(large_unsigned_integer(246913578024UL) * large_unsigned_integer(123456789012UL) == large_unsigned_integer::from_string("30483157506306967872288"s).value());
         CHECK(large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245"s).value() * large_unsigned_integer::from_string("1234567890987654321").value() == large_unsigned_integer::from_string("51864404980834242630409449768792397904982098404496001028394784645").value());
     }
+
+    SECTION("In place addition") {
+        auto value = large_unsigned_integer::from_string("12345678901234567890").value();
+        value += large_unsigned_integer::from_string("9876543211234567890").value();
+        CHECK(value == large_unsigned_integer::from_string("22222222112469135780").value());
+
+        large_unsigned_integer small(1u);
+        small += large_unsigned_integer(0xFFFFFFFFFFFFFFFFUL);
+        CHECK(small == large_unsigned_integer::from_string("18446744073709551616").value());
+
+        large_unsigned_integer carry(0xFFFFFFFFu);
+        carry += 1u;
+        CHECK(carry == 0x100000000UL);
+    }
+
+    SECTION("In place subtraction") {
+        auto value = large_unsigned_integer(0x100000000UL);
+        value -= large_unsigned_integer(1u);
+        CHECK(value == 0xFFFFFFFFu);
+
+        value -= value;
+        CHECK(value == 0u);
+    }
+
+    SECTION("In place multiplication and fused multiply-add") {
+        auto value = large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245").value();
+        value *= 100u;
+        CHECK(value == large_unsigned_integer::from_string("4201016838316013411044066574554776664997755624500").value());
+
+        value.mul_add(10u, 7u);
+        CHECK(value == large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245007").value());
+
+        value *= 0u;
+        CHECK(value == 0u);
+
+        value.mul_add(10u, 7u);
+        CHECK(value == 7u);
+    }
+
+    SECTION("In place operations reuse the storage") {
+        auto value = large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245").value();
+        value *= 1000u;
+        const auto* storage = value.get_data().data();
+
+        value -= large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245000").value();
+        value.mul_add(100u, 42u);
+        CHECK(value == 42u);
+        CHECK(value.get_data().data() == storage);
+    }
+
+    SECTION("Limbs are allocated from the given resource") {
+        std::array<std::byte, 1024> buffer;
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+        large_unsigned_integer value(&arena);
+        CHECK(value == 0u);
+        CHECK(value.get_resource() == &arena);
+
+        // Assignments keep the resource of the destination
+        value = large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245420101683831601341104406657455477666499775562454201016838316013411044066574554776664997755624542").value();
+        CHECK(value.get_resource() == &arena);
+        const auto* storage = reinterpret_cast<const std::byte*>(value.get_data().data());
+        CHECK((storage >= buffer.data() && storage < buffer.data() + buffer.size()));
+        CHECK(to_string(value) == "42010168383160134110440665745547766649977556245420101683831601341104406657455477666499775562454201016838316013411044066574554776664997755624542"s);
+    }
+
+    SECTION("Bit shifts") {
+        CHECK((large_unsigned_integer(1u) << 0) == 1u);
+        CHECK((large_unsigned_integer(1u) << 31) == 0x80000000u);
+        CHECK((large_unsigned_integer(1u) << 64) == large_unsigned_integer::from_string("18446744073709551616").value());
+        CHECK((large_unsigned_integer(0x123456789ABCDEFUL) << 36) == large_unsigned_integer::from_string("5634002667681019488601374720").value());
+        CHECK((large_unsigned_integer(0u) << 100) == 0u);
+
+        CHECK((large_unsigned_integer::from_string("5634002667681019488601374720").value() >> 36) == 0x123456789ABCDEFUL);
+        CHECK((large_unsigned_integer::from_string("18446744073709551616").value() >> 64) == 1u);
+        CHECK((large_unsigned_integer::from_string("18446744073709551616").value() >> 65) == 0u);
+        CHECK((large_unsigned_integer(0xFFFFFFFFFFFFFFFFUL) >> 4) == 0x0FFFFFFFFFFFFFFFUL);
+    }
+
+    SECTION("Bit width") {
+        CHECK(large_unsigned_integer(0u).bit_width() == 0);
+        CHECK(large_unsigned_integer(1u).bit_width() == 1);
+        CHECK(large_unsigned_integer(0xFFFFFFFFu).bit_width() == 32);
+        CHECK(large_unsigned_integer(0x100000000UL).bit_width() == 33);
+    }
+
+    SECTION("Conversion to string") {
+        CHECK(to_string(large_unsigned_integer(0u)) == "0"s);
+        CHECK(to_string(large_unsigned_integer(123456789012UL)) == "123456789012"s);
+        CHECK(to_string(large_unsigned_integer::from_string("340282366920938463463374607431768211456"s).value()) == "340282366920938463463374607431768211456"s);
+        CHECK(to_string(large_unsigned_integer::from_string("51864404980834242630409449768792397904982098404496001028394784645"s).value()) == "51864404980834242630409449768792397904982098404496001028394784645"s);
+
+        // Around the powers of ten used to split the number
+        CHECK(to_string(large_unsigned_integer(9999999999999999999ULL)) == "9999999999999999999"s);
+        CHECK(to_string(large_unsigned_integer(10000000000000000000ULL)) == "10000000000000000000"s);
+        for (const auto& number : { "100000000000000000000000000000000000001"s, "99999999999999999999999999999999999999"s, "1000000000000000000000000000000000000000000000000000000000000000000000000000"s, "12000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000034"s }) {
+            CHECK(to_string(large_unsigned_integer::from_string(number).value()) == number);
+        }
+
+        // 3^1000
+        auto power = large_unsigned_integer(1u);
+        for (int i = 0; i < 1000; ++i) {
+            power *= 3u;
+        }
+        CHECK(to_string(power) == "1322070819480806636890455259752144365965422032752148167664920368226828597346704899540778313850608061963909777696872582355950954582100618911865342725257953674027620225198320803878014774228964841274390400117588618041128947815623094438061566173054086674490506178125480344405547054397038895817465368254916136220830268563778582290228416398307887896918556404084898937609373242171846359938695516765018940588109060426089671438864102814350385648747165832010614366132173102768902855220001"s);
+    }
+
+    SECTION("Multiplication algorithms") {
+        using thresholds = large_unsigned_integer::multiplication_thresholds;
+        constexpr auto never = std::numeric_limits<size_t>::max();
+        const auto default_thresholds = large_unsigned_integer::get_multiplication_thresholds();
+
+        std::mt19937 engine(42);
+
+        // Balanced, unbalanced and squared operands
+        std::vector<std::pair<large_unsigned_integer, large_unsigned_integer>> operands;
+        for (const auto& [lhs_size, rhs_size] : { std::pair{ 7, 5 }, std::pair{ 64, 64 }, std::pair{ 100, 67 }, std::pair{ 300, 20 }, std::pair{ 257, 256 } }) {
+            operands.emplace_back(make_random(engine, lhs_size), make_random(engine, rhs_size));
+        }
+
+        large_unsigned_integer::set_multiplication_thresholds(thresholds{ never, never, never });
+        std::vector<large_unsigned_integer> expected_products;
+        std::vector<large_unsigned_integer> expected_squares;
+        for (const auto& [lhs, rhs] : operands) {
+            expected_products.emplace_back(lhs * rhs);
+            expected_squares.emplace_back(lhs * large_unsigned_integer(lhs));
+        }
+
+        for (const auto& forced_thresholds : { thresholds{ 4, never, never }, thresholds{ 4, 9, never }, thresholds{ 4, never, 2 } }) {
+            large_unsigned_integer::set_multiplication_thresholds(forced_thresholds);
+            for (size_t index = 0; index < operands.size(); ++index) {
+                const auto& [lhs, rhs] = operands[index];
+                CHECK(lhs * rhs == expected_products[index]);
+                CHECK(rhs * lhs == expected_products[index]);
+                CHECK(lhs * lhs == expected_squares[index]);
+            }
+        }
+
+        large_unsigned_integer::set_multiplication_thresholds(default_thresholds);
+    }
+
+    SECTION("SIMD kernels") {
+        using simd_kernel = large_unsigned_integer::simd_kernel;
+        const auto default_kernel = large_unsigned_integer::get_simd_kernel();
+
+        std::mt19937 engine(42);
+
+        // Long carry and borrow chains through whole vectors
+        const auto all_ones = large_unsigned_integer(large_unsigned_integer::collection_type(67, std::numeric_limits<large_unsigned_integer::underlying_type>::max()));
+        const auto power = large_unsigned_integer(1u) << (67 * large_unsigned_integer::nb_extended_type_bits);
+
+        std::vector<std::pair<large_unsigned_integer, large_unsigned_integer>> operands{ { all_ones, 1u }, { power, 1u }, { power, all_ones } };
+        for (const size_t size : { 1, 7, 8, 16, 17, 33, 100 }) {
+            operands.emplace_back(make_random(engine, size + 3), make_random(engine, size));
+        }
+
+        const auto compute = [&] {
+            std::vector<large_unsigned_integer> results;
+            for (auto [lhs, rhs] : operands) {
+                results.emplace_back(lhs + rhs);
+                results.emplace_back(lhs - rhs);
+                results.emplace_back(large_unsigned_integer(lhs) += rhs);
+                results.emplace_back(large_unsigned_integer(lhs) -= rhs);
+                results.emplace_back(large_unsigned_integer(lhs).mul_add(4294967291u, 4294967295u));
+                results.emplace_back(lhs * rhs);
+            }
+            return results;
+        };
+
+        const auto check_comparisons = [&] {
+            for (const auto& [lhs, rhs] : operands) {
+                CHECK((lhs <=> rhs) == std::strong_ordering::greater);
+                CHECK((lhs <=> (lhs + 1u)) == std::strong_ordering::less);
+                CHECK(lhs == large_unsigned_integer(lhs));
+            }
+        };
+
+        large_unsigned_integer::set_simd_kernel(simd_kernel::scalar);
+        CHECK(large_unsigned_integer::get_simd_kernel() == simd_kernel::scalar);
+        const auto expected = compute();
+        check_comparisons();
+
+        for (const auto kernel : { simd_kernel::avx2, simd_kernel::avx512 }) {
+            large_unsigned_integer::set_simd_kernel(kernel);
+            CHECK(large_unsigned_integer::get_simd_kernel() <= kernel);
+            CHECK(compute() == expected);
+            check_comparisons();
+        }
+
+        large_unsigned_integer::set_simd_kernel(default_kernel);
+        CHECK(large_unsigned_integer::get_simd_kernel() == default_kernel);
+    }
+
+    SECTION("Parallel execution") {
+        using thresholds = large_unsigned_integer::multiplication_thresholds;
+        constexpr auto never = std::numeric_limits<size_t>::max();
+        const auto default_thresholds = large_unsigned_integer::get_multiplication_thresholds();
+        const auto default_policy = large_unsigned_integer::get_parallel_policy();
+        CHECK(default_policy.nb_threads == 1);
+
+        std::mt19937 engine(42);
+
+        // Carries crossing the blocks of the linear operations
+        const auto all_ones = large_unsigned_integer(large_unsigned_integer::collection_type(1000, std::numeric_limits<large_unsigned_integer::underlying_type>::max()));
+        std::vector<std::pair<large_unsigned_integer, large_unsigned_integer>> operands{ { all_ones, 1u }, { all_ones + 1u, 1u } };
+        for (const auto& [lhs_size, rhs_size] : { std::pair{ 301, 300 }, std::pair{ 1000, 999 }, std::pair{ 2000, 300 } }) {
+            operands.emplace_back(make_random(engine, lhs_size), make_random(engine, rhs_size));
+        }
+
+        const auto compute = [&] {
+            std::vector<large_unsigned_integer> results;
+            for (const auto& [lhs, rhs] : operands) {
+                results.emplace_back(lhs + rhs);
+                results.emplace_back(lhs - rhs);
+                results.emplace_back(large_unsigned_integer(lhs) += rhs);
+                results.emplace_back(large_unsigned_integer(lhs) -= rhs);
+                results.emplace_back(lhs * rhs);
+                results.emplace_back(lhs * large_unsigned_integer(lhs));
+            }
+            return results;
+        };
+
+        for (const auto& forced_thresholds : { thresholds{ 40, never, never }, thresholds{ 40, 100, never }, thresholds{ 40, never, 64 } }) {
+            large_unsigned_integer::set_multiplication_thresholds(forced_thresholds);
+            large_unsigned_integer::set_parallel_policy(default_policy);
+            const auto expected = compute();
+
+            large_unsigned_integer::set_parallel_policy({ 4, 64, 256 });
+            CHECK(large_unsigned_integer::get_parallel_policy().nb_threads == 4);
+            CHECK(compute() == expected);
+        }
+
+        large_unsigned_integer::set_multiplication_thresholds(default_thresholds);
+        large_unsigned_integer::set_parallel_policy(default_policy);
+        CHECK(large_unsigned_integer::get_parallel_policy().nb_threads == 1);
+    }
+
+    SECTION("Division") {
+        const auto value = large_unsigned_integer::from_string("42010168383160134110440665745547766649977556245").value();
+        CHECK(value / 1000000007u == large_unsigned_integer::from_string("42010168089088957486817963337822023285").value());
+        CHECK(value % 1000000007u == 223393250u);
+        CHECK(value / value == 1u);
+        CHECK(value % value == 0u);
+        CHECK(large_unsigned_integer(41u) / value == 0u);
+        CHECK(large_unsigned_integer(41u) % value == 41u);
+        CHECK_THROWS_AS(value / large_unsigned_integer(0u), std::domain_error);
+        CHECK_THROWS_AS(large_unsigned_integer(value) /= 0u, std::domain_error);
+
+        auto copy = value;
+        copy /= 10u;
+        CHECK(copy == large_unsigned_integer::from_string("4201016838316013411044066574554776664997755624").value());
+
+        // Knuth's algorithm D and Barrett's method against the definition
+        std::mt19937 engine(42);
+
+        for (const auto& [dividend_size, divisor_size] : { std::pair{ 3, 2 }, std::pair{ 40, 7 }, std::pair{ 50, 49 }, std::pair{ 300, 100 }, std::pair{ 1000, 200 }, std::pair{ 401, 400 }, std::pair{ 20000, 8200 } }) {
+            // The most significant limbs are not null to get operands of the requested sizes
+            auto dividend_data = make_random(engine, dividend_size);
+            dividend_data.back() |= 1;
+            auto divisor_data = make_random(engine, divisor_size);
+            divisor_data.back() |= 1;
+            const auto dividend = large_unsigned_integer(dividend_data);
+            const auto divisor = large_unsigned_integer(divisor_data) >> (divisor_size % 31);
+            const auto [quotient, remainder] = divmod(dividend, divisor);
+            CHECK(remainder < divisor);
+            CHECK(quotient * divisor + remainder == dividend);
+        }
+
+        // The top limb of the remainder estimate equals the top limb of the divisor
+        const auto power = large_unsigned_integer(1u) << 1000;
+        const auto divisor = power - large_unsigned_integer(1u);
+        CHECK(divmod(power * power, divisor) == std::pair{ power + large_unsigned_integer(1u), large_unsigned_integer(1u) });
+    }
+
+    SECTION("Integer square root") {
+        for (const auto value : { 0ULL, 1ULL, 2ULL, 3ULL, 4ULL, 15ULL, 16ULL, 17ULL, 4294967295ULL, 4294967296ULL, 18446744073709551615ULL }) {
+            const auto expected = static_cast<unsigned long long>(std::sqrt(static_cast<long double>(value)));
+            CHECK(isqrt(large_unsigned_integer(value)) == expected);
+        }
+
+        // (10^50 + 1)^2 - 1 and (10^50 + 1)^2
+        const auto root = large_unsigned_integer::from_string("100000000000000000000000000000000000000000000000001").value();
+        const auto square = root * root;
+        CHECK(isqrt(square) == root);
+        CHECK(isqrt(square - large_unsigned_integer(1u)) == root - large_unsigned_integer(1u));
+    }
+
+    SECTION("Conversion from string") {
+        CHECK(large_unsigned_integer::from_string("0000000000000000000000000000000000000000042"s).value() == 42u);
+        CHECK(large_unsigned_integer::from_string(std::string_view("18446744073709551616")).value() == (large_unsigned_integer(1u) << 64));
+
+        // Chunks with leading zeros and an odd number of chunks
+        std::string number = "1";
+        for (int i = 0; i < 100; ++i) {
+            number += "0000000000000000001";
+        }
+        CHECK(to_string(large_unsigned_integer::from_string(number).value()) == number);
+
+        std::mt19937 engine(42);
+        std::uniform_int_distribution<int> distribution(0, 9);
+        std::string random_number(5000, '1');
+        std::ranges::generate(random_number | std::views::drop(1), [&] { return static_cast<char>('0' + distribution(engine)); });
+        CHECK(to_string(large_unsigned_integer::from_string(random_number).value()) == random_number);
+    }
 }
\ No newline at end of file
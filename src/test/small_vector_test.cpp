@@ -0,0 +1,121 @@
+#include "../small_vector.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+// Overwrite the released memory so that reading it after the release is detected
+class scribbling_resource : public std::pmr::memory_resource {
+private:
+    void* do_allocate(size_t bytes_, size_t alignment_) override {
+        return std::pmr::new_delete_resource()->allocate(bytes_, alignment_);
+    }
+
+    void do_deallocate(void* pointer_, size_t bytes_, size_t alignment_) override {
+        std::memset(pointer_, 0xFF, bytes_);
+        std::pmr::new_delete_resource()->deallocate(pointer_, bytes_, alignment_);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other_) const noexcept override {
+        return this == &other_;
+    }
+};
+
+}
+
+TEST_CASE("Small vector") {
+    using collection = small_vector<std::uint32_t, 4>;
+
+    SECTION("Empty on construction") {
+        collection values;
+        CHECK(values.empty());
+        CHECK(values.is_inline());
+        CHECK(values.capacity() == 4);
+    }
+
+    SECTION("Values are stored in place up to the inline capacity") {
+        collection values{ 1, 2, 3, 4 };
+        CHECK(values.is_inline());
+        CHECK(values == collection({ 1, 2, 3, 4 }));
+    }
+
+    SECTION("Values spill to the heap beyond the inline capacity") {
+        collection values{ 1, 2, 3, 4 };
+        values.emplace_back(5u);
+        CHECK(!values.is_inline());
+        CHECK(std::vector<std::uint32_t>(values.begin(), values.end()) == std::vector<std::uint32_t>({ 1, 2, 3, 4, 5 }));
+    }
+
+    SECTION("Resize fills the new values") {
+        collection values(2, 7u);
+        values.resize(6, 9u);
+        CHECK(values == collection({ 7, 7, 9, 9, 9, 9 }));
+
+        values.resize(1);
+        CHECK(values == collection({ 7 }));
+    }
+
+    SECTION("Values of the collection can be appended while it grows") {
+        scribbling_resource resource;
+        collection values({ 1, 2, 3, 4, 5 }, &resource);
+        while (values.size() < values.capacity()) {
+            values.push_back(6u);
+        }
+
+        // The argument lives in the storage released by the growth
+        values.push_back(values[0]);
+        CHECK(values.back() == 1u);
+
+        const size_t size = values.size();
+        values.shrink_to_fit();
+        values.resize(2 * size, values[1]);
+        CHECK(values.back() == 2u);
+        CHECK(values[size] == 2u);
+    }
+
+    SECTION("Shrink to fit goes back in place") {
+        collection values(10, 1u);
+        values.resize(3);
+        values.shrink_to_fit();
+        CHECK(values.is_inline());
+        CHECK(values == collection({ 1, 1, 1 }));
+    }
+
+    SECTION("Erase removes a range") {
+        collection values{ 1, 2, 3, 4, 5, 6 };
+        values.erase(values.begin() + 1, values.begin() + 3);
+        CHECK(values == collection({ 1, 4, 5, 6 }));
+    }
+
+    SECTION("Copy is deep") {
+        collection values{ 1, 2, 3, 4, 5 };
+        collection copy = values;
+        copy[0] = 42;
+        CHECK(values[0] == 1);
+        CHECK(copy == collection({ 42, 2, 3, 4, 5 }));
+    }
+
+    SECTION("Move transfers the heap storage") {
+        collection values{ 1, 2, 3, 4, 5 };
+        const auto* storage = values.data();
+
+        collection moved = std::move(values);
+        CHECK(moved.data() == storage);
+        CHECK(moved == collection({ 1, 2, 3, 4, 5 }));
+        CHECK(values.empty());
+        CHECK(values.is_inline());
+    }
+
+    SECTION("Move of inline values copies them") {
+        collection values{ 1, 2 };
+        collection moved;
+        moved = std::move(values);
+        CHECK(moved.is_inline());
+        CHECK(moved == collection({ 1, 2 }));
+    }
+}
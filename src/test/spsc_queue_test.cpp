@@ -3,6 +3,10 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+
 TEST_CASE("Single producer single consumer queue") {
     SECTION("Empty on construction") {
         spsc_queue<int> queue;
@@ -39,7 +43,7 @@ TEST_CASE("Single producer single consumer queue") {
         CHECK(queue.pop() == 2);
     }
 
-    SECTION("Emplace values are popped in the same order with reallocation") {
+    SECTION("Emplace values are popped in the same order across segments") {
         spsc_queue<int> queue(2);
         queue.emplace(1);
         queue.emplace(2);
@@ -50,8 +54,8 @@ TEST_CASE("Single producer single consumer queue") {
         CHECK(queue.pop() == 3);
     }
 
-    SECTION("Emplace values are popped in the same order with reallocation after pop") {
-        spsc_queue<int> queue(2, 2);
+    SECTION("Emplace values are popped in the same order across segments after pop") {
+        spsc_queue<int> queue(2);
         queue.emplace(1);
         CHECK(queue.pop() == 1);
         queue.emplace(2);
@@ -88,9 +92,9 @@ TEST_CASE("Single producer single consumer queue") {
         CHECK(result == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
     }
 
-    SECTION("Emplace values are popped in the same order in multithreaded context with reallocation") {
+    SECTION("Emplace values are popped in the same order in multithreaded context across segments") {
         constexpr size_t nb_data = 10;
-        spsc_queue<int> queue(nb_data / 2, nb_data); // Force future reallocation
+        spsc_queue<int> queue(2); // Force several segments
         std::jthread producer([&]() {
             for (int i = 0; i < nb_data; ++i) {
                 queue.emplace(i);
@@ -114,4 +118,92 @@ TEST_CASE("Single producer single consumer queue") {
 
         CHECK(result == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
     }
-}
\ No newline at end of file
+
+    SECTION("Emplace values are popped in the same order with every wait strategy") {
+        constexpr int nb_data = 10000;
+        const auto check_strategy = [&]<typename WaitStrategy>(const WaitStrategy& wait_strategy_) {
+            spsc_queue<int, WaitStrategy> queue(16, 16, wait_strategy_);
+            std::jthread producer([&]() {
+                for (int i = 0; i < nb_data; ++i) {
+                    queue.emplace(i);
+                }
+            });
+
+            std::vector<int> result;
+            result.reserve(nb_data);
+            for (int i = 0; i < nb_data; ++i) {
+                result.emplace_back(queue.pop());
+            }
+            producer.join();
+
+            CHECK(std::ranges::equal(result, std::views::iota(0, nb_data)));
+        };
+
+        check_strategy(spin_yield_wait_strategy{});
+        check_strategy(atomic_wait_strategy{});
+        check_strategy(hybrid_wait_strategy(0));
+        check_strategy(hybrid_wait_strategy{});
+    }
+
+    SECTION("Stop request wakes up a sleeping consumer") {
+        spsc_queue<int, atomic_wait_strategy> queue;
+        std::stop_source stop_source;
+        std::jthread stopper([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            stop_source.request_stop();
+        });
+
+        CHECK(!queue.pop(stop_source.get_token()).has_value());
+    }
+
+    SECTION("Values are still popped after a stop request") {
+        spsc_queue<int, atomic_wait_strategy> queue;
+        std::stop_source stop_source;
+        queue.emplace(1);
+        stop_source.request_stop();
+
+        CHECK(queue.pop(stop_source.get_token()) == 1);
+        CHECK(!queue.pop(stop_source.get_token()).has_value());
+    }
+
+    SECTION("Released segments are recycled") {
+        spsc_queue<int> queue(4);
+        for (int i = 0; i < 100; ++i) {
+            queue.emplace(i);
+            CHECK(queue.pop() == i);
+        }
+        CHECK(queue.nb_allocated_segments() <= 2);
+    }
+
+    SECTION("High-water mark applies backpressure to the producer") {
+        constexpr int nb_data = 1000;
+        spsc_queue<int> queue(4, 2 * 4 * sizeof(int));
+        std::jthread producer([&]() {
+            for (int i = 0; i < nb_data; ++i) {
+                queue.emplace(i);
+            }
+        });
+
+        std::vector<int> result;
+        for (int i = 0; i < nb_data; ++i) {
+            result.emplace_back(queue.pop());
+        }
+        producer.join();
+
+        CHECK(std::ranges::equal(result, std::views::iota(0, nb_data)));
+        CHECK(queue.nb_allocated_segments() <= 2);
+    }
+
+    SECTION("Stop request interrupts a producer waiting for memory") {
+        spsc_queue<int> queue(1, 0);
+        std::stop_source stop_source;
+        CHECK(queue.emplace(stop_source.get_token(), 1));
+        CHECK(queue.emplace(stop_source.get_token(), 2));
+
+        stop_source.request_stop();
+        CHECK(!queue.emplace(stop_source.get_token(), 3));
+        CHECK(queue.pop() == 1);
+        CHECK(queue.pop() == 2);
+        CHECK(queue.empty());
+    }
+}
@@ -0,0 +1,68 @@
+#include "../square_root_cache.hpp"
+#include "../square_root.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Defined in square_root_test.cpp
+std::string first_digits(generator<char>& generator_, size_t count_);
+std::string first_digits(generator<char>&& generator_, size_t count_);
+
+TEST_CASE("Square root cache") {
+    SECTION("Streams have the same digits as the digit by digit method") {
+        square_root_cache cache;
+        for (const uint64_t value : { 0ULL, 1ULL, 4ULL, 2ULL, 42ULL, 1000000ULL, 18446744073709551615ULL }) {
+            CHECK(first_digits(cache.stream(value), 700) == first_digits(compute_square_root_digit_by_digit_method(value), 700));
+        }
+    }
+
+    SECTION("Streams of the same radicand share the prefix") {
+        square_root_cache cache;
+        const auto expected = first_digits(compute_square_root_digit_by_digit_method(42), 1000);
+        CHECK(first_digits(cache.stream(42), 1000) == expected);
+        CHECK(first_digits(cache.stream(42), 500) == expected.substr(0, 500));
+        CHECK(first_digits(cache.stream(42), 1000) == expected);
+        CHECK(cache.get_nb_entries() == 1);
+        CHECK(cache.get_memory_usage() > 0);
+    }
+
+    SECTION("Concurrent streams extend the same prefix") {
+        square_root_cache cache;
+        const auto expected = first_digits(compute_square_root_digit_by_digit_method(2), 5000);
+
+        std::vector<std::string> results(4);
+        {
+            std::vector<std::jthread> readers;
+            for (auto& result : results) {
+                readers.emplace_back([&cache, &result]() { result = first_digits(cache.stream(2), 5000); });
+            }
+        }
+
+        for (const auto& result : results) {
+            CHECK(result == expected);
+        }
+    }
+
+    SECTION("Least recently streamed radicands are evicted beyond the budget") {
+        square_root_cache cache(1);
+        CHECK(first_digits(cache.stream(2), 100) == first_digits(compute_square_root_digit_by_digit_method(2), 100));
+        CHECK(cache.get_nb_entries() == 0);
+        CHECK(cache.get_memory_usage() == 0);
+
+        // An evicted radicand stays counted while it is streamed
+        {
+            auto stream = cache.stream(5);
+            CHECK(first_digits(stream, 100).size() == 100);
+            CHECK(cache.get_nb_entries() == 0);
+            CHECK(cache.get_memory_usage() > 0);
+        }
+        CHECK(cache.get_memory_usage() == 0);
+
+        // Perfect squares do not use any block
+        CHECK(first_digits(cache.stream(9), 10) == "3");
+        CHECK(cache.get_nb_entries() == 1);
+    }
+}
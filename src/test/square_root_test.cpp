@@ -1,11 +1,33 @@
 #include "../square_root.hpp"
 
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <random>
+#include <span>
 #include <thread>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+// Concatenate the first count_ characters of generator_, which is left at the next character
+std::string first_digits(generator<char>& generator_, size_t count_) {
+    std::string result;
+    while (result.size() < count_ && generator_.has_value()) {
+        result += generator_.value();
+    }
+    return result;
+}
+
+std::string first_digits(generator<char>&& generator_, size_t count_) {
+    return first_digits(generator_, count_);
+}
+
 TEST_CASE("Square root") {
     SECTION("compute_square_root_digit_by_digit_method with stream") {
         using namespace std::string_literals;
@@ -34,4 +56,253 @@ TEST_CASE("Square root") {
         }
         CHECK(stream.str() == "6.4807406984078602309659674360879966577052043070583465497113543978096173778440443714003609066056102356"s);
     }
+
+    SECTION("compute_square_root_digit_by_digit_method with block engine") {
+        using namespace std::string_literals;
+
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(0), 10) == "0"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(1), 10) == "1"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(4), 10) == "2"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(1000000000000000000ULL), 30) == "1000000000"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(42), 102) == "6.4807406984078602309659674360879966577052043070583465497113543978096173778440443714003609066056102356"s);
+
+        // Both engines must produce the same digits
+        for (const auto value : { 2ULL, 99ULL, 12345678901234567ULL, 999999999999999999ULL, 18446744073709551615ULL }) {
+            CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(value), 500) == first_digits(compute_square_root_digit_by_digit_method(value), 500));
+        }
+
+        // The buffers can be allocated from any resource
+        std::pmr::monotonic_buffer_resource arena;
+        CHECK(first_digits(compute_square_root_digit_by_digit_method(2, &arena), 500) == first_digits(compute_square_root_digit_by_digit_method(2), 500));
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(2, &arena), 500) == first_digits(compute_square_root_digit_by_digit_method(2), 500));
+
+        std::ostringstream stream;
+        std::stop_token stop;
+        compute_square_root_digit_by_digit_method<square_root_engine::block>(stream, 4, stop);
+        CHECK(stream.str() == "2"s);
+    }
+
+    SECTION("compute_square_root_digit_by_digit_method with reciprocal engines") {
+        using namespace std::string_literals;
+
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::newton>(0), 10) == "0"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::goldschmidt>(1), 10) == "1"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::newton>(4), 10) == "2"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::goldschmidt>(1000000000000000000ULL), 30) == "1000000000"s);
+        CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::goldschmidt>(42), 102) == "6.4807406984078602309659674360879966577052043070583465497113543978096173778440443714003609066056102356"s);
+
+        // Same digits as the digit by digit method, across several doubling runs
+        for (const auto value : { 2ULL, 3ULL, 99ULL, 12345678901234567ULL, 999999999999999999ULL, 18446744073709551615ULL }) {
+            const auto expected = first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(value), 1000);
+            CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::newton>(value), 1000) == expected);
+            CHECK(first_digits(compute_square_root_digit_by_digit_method<square_root_engine::goldschmidt>(value), 1000) == expected);
+        }
+
+        // The iterations are resumed, fewer digits only need the last unit to be checked
+        for (const auto engine : { square_root_engine::newton, square_root_engine::goldschmidt }) {
+            details::square_root_reciprocal_computer computer(2, engine);
+            CHECK(to_string(computer(300)) == "1"s + compute_square_root_digits(2, 300).substr(2));
+            CHECK(to_string(computer(10)) == "14142135623"s);
+            CHECK(to_string(computer(0)) == "1"s);
+        }
+    }
+
+    SECTION("compute_square_root_digit_by_digit_method with sink") {
+        using namespace std::string_literals;
+
+        // Record the chunks and stop the stream once enough digits are received
+        struct recording_sink {
+            explicit recording_sink(size_t nb_digits_ = std::numeric_limits<size_t>::max())
+                : nb_digits(nb_digits_) {}
+
+            void write(std::span<const digit_chunk> chunks_) {
+                for (const auto& chunk : chunks_) {
+                    max_chunk_size = std::max(max_chunk_size, chunk.size());
+                    digits += chunk;
+                }
+                if (digits.size() >= nb_digits) {
+                    stop_source.request_stop();
+                }
+            }
+
+            void flush() {
+                ++nb_flushes;
+            }
+
+            size_t nb_digits;
+            std::stop_source stop_source;
+            std::string digits;
+            size_t max_chunk_size = 0;
+            size_t nb_flushes = 0;
+        };
+
+        recording_sink perfect_square_sink;
+        compute_square_root_digit_by_digit_method(perfect_square_sink, 1000000, perfect_square_sink.stop_source.get_token());
+        CHECK(perfect_square_sink.digits == "1000"s);
+        CHECK(perfect_square_sink.nb_flushes >= 1);
+
+        recording_sink sink{ 1000 };
+        compute_square_root_digit_by_digit_method<square_root_engine::block>(sink, 2, sink.stop_source.get_token(), { .chunk_size = 64 });
+        REQUIRE(sink.digits.size() >= 1000);
+        CHECK(sink.max_chunk_size <= 64);
+        CHECK(sink.digits.substr(0, 1000) == compute_square_root_digits(2, 998));
+
+        // An exception of the sink stops the producer and is passed on
+        struct throwing_sink {
+            void write(std::span<const digit_chunk>) {
+                if (++nb_writes == 2) {
+                    throw std::runtime_error("Disk full");
+                }
+            }
+
+            void flush() {}
+
+            size_t nb_writes = 0;
+        };
+
+        throwing_sink failing_sink;
+        std::stop_source never_stop;
+        CHECK_THROWS_AS(compute_square_root_digit_by_digit_method(failing_sink, 2, never_stop.get_token(), { .chunk_size = 16 }), std::runtime_error);
+        CHECK(failing_sink.nb_writes == 2);
+
+        recording_sink newton_sink{ 1000 };
+        compute_square_root_digit_by_digit_method<square_root_engine::newton>(newton_sink, 2, newton_sink.stop_source.get_token(), { .chunk_size = 64 });
+        REQUIRE(newton_sink.digits.size() >= 1000);
+        CHECK(newton_sink.digits.substr(0, 1000) == compute_square_root_digits(2, 998));
+    }
+
+    SECTION("Checkpoint and resume") {
+        using namespace std::string_literals;
+
+        std::vector<square_root_checkpoint> checkpoints;
+        const square_root_checkpoint_policy policy{ 100, [&](const square_root_checkpoint& checkpoint_) { checkpoints.push_back(checkpoint_); } };
+        const auto digits = first_digits(compute_square_root_digit_by_digit_method(2, policy), 1002);
+        CHECK(digits == first_digits(compute_square_root_digit_by_digit_method(2), 1002));
+        REQUIRE(checkpoints.size() == 9);
+        CHECK(checkpoints[4].value == 2);
+        CHECK(checkpoints[4].nb_fractional_digits == 500);
+
+        // The resumed stream continues with the next fractional digit
+        CHECK(first_digits(resume_square_root_digit_by_digit_method(checkpoints[4]), 500) == digits.substr(502));
+
+        // Binary round trip
+        std::stringstream stream;
+        save_checkpoint(stream, checkpoints[4]);
+        CHECK(load_checkpoint(stream) == checkpoints[4]);
+
+        std::stringstream invalid_stream("not a checkpoint");
+        CHECK_THROWS_AS(load_checkpoint(invalid_stream), std::runtime_error);
+
+        std::stringstream truncated_stream(stream.str().substr(0, 30));
+        CHECK_THROWS_AS(load_checkpoint(truncated_stream), std::runtime_error);
+
+        // A corrupt number of limbs (2^40 here) is reported without allocating it
+        auto corrupt_bytes = stream.str();
+        std::fill_n(corrupt_bytes.begin() + 26, 8, '\0');
+        corrupt_bytes[31] = '\1';
+        std::stringstream corrupt_stream(corrupt_bytes);
+        CHECK_THROWS_AS(load_checkpoint(corrupt_stream), std::runtime_error);
+
+        // Snapshots saved to a file, resumed snapshots carry on counting
+        // Unique name, so that concurrent runs do not overwrite the checkpoint of each other
+        const auto path = std::filesystem::temp_directory_path() / ("square_root_checkpoint_test_" + std::to_string(std::random_device{}()) + ".bin");
+        const auto resumed_digits = first_digits(resume_square_root_digit_by_digit_method(checkpoints[4], make_file_checkpoint_policy(path, 250)), 500);
+        CHECK(resumed_digits == digits.substr(502));
+
+        std::ifstream file(path, std::ios::binary);
+        const auto saved_checkpoint = load_checkpoint(file);
+        CHECK(saved_checkpoint.nb_fractional_digits == 750);
+        CHECK(first_digits(resume_square_root_digit_by_digit_method(saved_checkpoint), 250) == digits.substr(752));
+
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    SECTION("compute_square_root_digit_range") {
+        using namespace std::string_literals;
+
+        CHECK(compute_square_root_digit_range(-1, 0, 10) == "nan"s);
+        CHECK(compute_square_root_digit_range(42, 10, 0) == ""s);
+        CHECK(compute_square_root_digit_range(4, 100, 5) == "00000"s);
+        CHECK(compute_square_root_digit_range(42, 0, 10) == "4807406984"s);
+
+        // Windows of the fractional digits, including leading zeros
+        const auto digits = compute_square_root_digits(2, 2000);
+        for (const auto& [offset, count] : { std::pair{ 0, 1 }, std::pair{ 1, 17 }, std::pair{ 500, 100 }, std::pair{ 1000, 1000 }, std::pair{ 1999, 1 } }) {
+            CHECK(compute_square_root_digit_range(2, offset, count) == digits.substr(2 + offset, count));
+        }
+        CHECK(compute_square_root_digit_range(99, 123, 3) == compute_square_root_digits(99, 126).substr(2 + 123, 3));
+    }
+
+    SECTION("compute_square_roots") {
+        const std::vector<int64_t> values{ 2, 4, -1, 42, 1000000, 99, 0, 18 };
+        std::vector<std::ostringstream> streams(values.size());
+        std::vector<ostream_digit_sink> sinks;
+        for (auto& stream : streams) {
+            sinks.emplace_back(stream);
+        }
+
+        thread_pool pool(3);
+        const auto statistics = compute_square_roots(pool, std::span<const int64_t>(values), 200, std::span(sinks));
+
+        size_t nb_characters = 0;
+        for (size_t index = 0; index < values.size(); ++index) {
+            CHECK(streams[index].str() == compute_square_root_digits(values[index], 200));
+            nb_characters += streams[index].str().size();
+        }
+
+        CHECK(statistics.nb_radicands == values.size());
+        CHECK(statistics.nb_perfect_squares == 3);
+        CHECK(statistics.nb_characters == nb_characters);
+        CHECK(statistics.nb_threads == 3);
+        CHECK(statistics.get_characters_per_second() > 0.0);
+    }
+
+    SECTION("compute_square_roots_in_lockstep") {
+        using simd_kernel = large_unsigned_integer::simd_kernel;
+
+        // More radicands than lanes, with lanes of very different sizes
+        std::vector<int64_t> values{ 2, 4, -1, 42, 0, 1, 99, 18, 1000000, 999999999999, std::numeric_limits<int64_t>::max(), 3, 5, 4611686014132420609 };
+        for (int64_t value = 1000; values.size() < 37; value += 997) {
+            values.push_back(value);
+        }
+
+        const auto default_kernel = large_unsigned_integer::get_simd_kernel();
+        for (const auto kernel : { simd_kernel::scalar, simd_kernel::avx2, simd_kernel::avx512 }) {
+            large_unsigned_integer::set_simd_kernel(kernel);
+            const auto digits = compute_square_roots_in_lockstep(std::span<const int64_t>(values), 300);
+            REQUIRE(digits.size() == values.size());
+            for (size_t index = 0; index < values.size(); ++index) {
+                CHECK(digits[index] == compute_square_root_digits(values[index], 300));
+            }
+        }
+        large_unsigned_integer::set_simd_kernel(default_kernel);
+
+        CHECK(compute_square_roots_in_lockstep(std::span<const int>(), 10).empty());
+
+        // Without fractional digits there is no decimal point either
+        const auto integral_parts = compute_square_roots_in_lockstep(std::span<const int64_t>(values), 0);
+        CHECK(integral_parts[3] == "6");
+        for (size_t index = 0; index < values.size(); ++index) {
+            CHECK(integral_parts[index] == compute_square_root_digits(values[index], 0));
+        }
+    }
+
+    SECTION("compute_square_root_digits") {
+        using namespace std::string_literals;
+
+        CHECK(compute_square_root_digits(-1, 10) == "nan"s);
+        CHECK(compute_square_root_digits(0, 10) == "0"s);
+        CHECK(compute_square_root_digits(1, 10) == "1"s);
+        CHECK(compute_square_root_digits(4, 10) == "2"s);
+        CHECK(compute_square_root_digits(42, 0) == "6"s);
+        CHECK(compute_square_root_digits(18446744073709551615ULL, 0) == "4294967295"s);
+        CHECK(compute_square_root_digits(42, 100) == "6.4807406984078602309659674360879966577052043070583465497113543978096173778440443714003609066056102356"s);
+
+        // Same digits as the digit by digit method
+        for (const auto value : { 2ULL, 99ULL, 12345678901234567ULL, 18446744073709551615ULL }) {
+            const auto digits = compute_square_root_digits(value, 1000);
+            CHECK(digits == first_digits(compute_square_root_digit_by_digit_method<square_root_engine::block>(value), digits.size()));
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "../thread_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+TEST_CASE("Thread pool") {
+    SECTION("All the submitted tasks are run") {
+        thread_pool pool(4);
+        CHECK(pool.get_nb_threads() == 4);
+
+        std::atomic_int counter{ 0 };
+        for (int index = 0; index < 1000; ++index) {
+            pool.submit([&counter]() { counter.fetch_add(1); });
+        }
+        pool.wait();
+        CHECK(counter == 1000);
+    }
+
+    SECTION("Tasks can submit tasks") {
+        thread_pool pool(2);
+        std::atomic_int counter{ 0 };
+        for (int index = 0; index < 10; ++index) {
+            pool.submit([&pool, &counter]() {
+                for (int sub_index = 0; sub_index < 10; ++sub_index) {
+                    pool.submit([&counter]() { counter.fetch_add(1); });
+                }
+            });
+        }
+        pool.wait();
+        CHECK(counter == 100);
+    }
+
+    SECTION("Idle threads steal the tasks of busy ones") {
+        thread_pool pool(2);
+        std::atomic_int counter{ 0 };
+        size_t nb_stolen_tasks_before = 0;
+
+        // All the tasks are queued by a single thread of the pool, which is kept busy
+        // The queuing task itself may be stolen, so only the steals after it starts are counted
+        pool.submit([&pool, &counter, &nb_stolen_tasks_before]() {
+            nb_stolen_tasks_before = pool.get_nb_stolen_tasks();
+            for (int index = 0; index < 10; ++index) {
+                pool.submit([&counter]() { counter.fetch_add(1); });
+            }
+            while (counter < 10) {
+                std::this_thread::yield();
+            }
+        });
+        pool.wait();
+        CHECK(counter == 10);
+        CHECK(pool.get_nb_stolen_tasks() - nb_stolen_tasks_before == 10);
+    }
+
+    SECTION("First exception is rethrown by wait") {
+        thread_pool pool(2);
+        pool.submit([]() { throw std::runtime_error("error"); });
+        CHECK_THROWS_AS(pool.wait(), std::runtime_error);
+
+        // The pool is still usable
+        std::atomic_int counter{ 0 };
+        pool.submit([&counter]() { counter.fetch_add(1); });
+        pool.wait();
+        CHECK(counter == 1);
+    }
+
+    SECTION("Task groups are waited for independently") {
+        thread_pool pool(2);
+        thread_pool::task_group failing_group(pool);
+        thread_pool::task_group group(pool);
+
+        std::atomic_int counter{ 0 };
+        failing_group.submit([]() { throw std::runtime_error("error"); });
+        for (int index = 0; index < 100; ++index) {
+            group.submit([&counter]() { counter.fetch_add(1); });
+        }
+
+        CHECK_NOTHROW(group.wait());
+        CHECK(counter == 100);
+        CHECK_THROWS_AS(failing_group.wait(), std::runtime_error);
+        CHECK_NOTHROW(pool.wait());
+    }
+
+    SECTION("A task of the pool can wait for a group") {
+        // With a single thread the group only progresses if the waiting thread runs its tasks
+        thread_pool pool(1);
+        std::atomic_int counter{ 0 };
+        pool.submit([&pool, &counter]() {
+            thread_pool::task_group group(pool);
+            for (int index = 0; index < 10; ++index) {
+                group.submit([&counter]() { counter.fetch_add(1); });
+            }
+            group.wait();
+        });
+        pool.wait();
+        CHECK(counter == 10);
+    }
+}
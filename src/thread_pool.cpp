@@ -0,0 +1,244 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Pool and queue of the current thread, if it is a thread of a pool
+thread_local const thread_pool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+// Whether the task running on the current thread was stolen from another queue
+thread_local bool current_task_stolen = false;
+
+} // Anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+thread_pool::thread_pool(size_t nb_threads_) {
+    const size_t nb_threads = std::max(nb_threads_, size_t{ 1 });
+    for (size_t index = 0; index < nb_threads; ++index) {
+        queues.emplace_back(std::make_unique<task_queue>());
+    }
+
+    threads.reserve(nb_threads);
+    for (size_t index = 0; index < nb_threads; ++index) {
+        threads.emplace_back([this, index](std::stop_token stop_) { run(stop_, index); });
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+thread_pool::~thread_pool() {
+    // The threads are woken up by the stop requests
+    for (auto& thread : threads) {
+        thread.request_stop();
+    }
+    threads.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] thread_pool& thread_pool::get_default() {
+    static thread_pool instance;
+    return instance;
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::submit(task_type task_) {
+    {
+        std::lock_guard lock(done_mutex);
+        ++nb_pending_tasks;
+    }
+
+    const size_t index = current_pool == this ? current_queue : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task_));
+    }
+
+    {
+        std::lock_guard lock(wake_mutex);
+        ++nb_queued_tasks;
+    }
+    wake.notify_one();
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::wait() {
+    std::unique_lock lock(done_mutex);
+    done.wait(lock, [this]() { return nb_pending_tasks == 0; });
+
+    if (exception) {
+        std::rethrow_exception(std::exchange(exception, nullptr));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::run(std::stop_token stop_, size_t index_) {
+    current_pool = this;
+    current_queue = index_;
+
+    while (true) {
+        // Reserve one of the queued tasks, it is in one of the queues
+        {
+            std::unique_lock lock(wake_mutex);
+            if (!wake.wait(lock, stop_, [this]() { return nb_queued_tasks > 0; })) {
+                return;
+            }
+            --nb_queued_tasks;
+        }
+
+        run_reserved_task(index_);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] bool thread_pool::try_run_queued_task(size_t index_) {
+    {
+        std::lock_guard lock(wake_mutex);
+        if (nb_queued_tasks == 0) {
+            return false;
+        }
+        --nb_queued_tasks;
+    }
+
+    run_reserved_task(index_);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::run_reserved_task(size_t index_) {
+    task_type task;
+    bool stolen = false;
+    while (!try_pop(index_, task)) {
+        if (try_steal(index_, task)) {
+            stolen = true;
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    // Tasks may be nested when a task waits for a group
+    const bool outer_task_stolen = std::exchange(current_task_stolen, stolen);
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard lock(done_mutex);
+        if (!exception) {
+            exception = std::current_exception();
+        }
+    }
+    current_task_stolen = outer_task_stolen;
+
+    std::lock_guard lock(done_mutex);
+    if (--nb_pending_tasks == 0) {
+        done.notify_all();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] bool thread_pool::try_pop(size_t index_, task_type& task_) {
+    auto& queue = *queues[index_];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+
+    task_ = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+[[nodiscard]] bool thread_pool::try_steal(size_t index_, task_type& task_) {
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        auto& queue = *queues[(index_ + offset) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task_ = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            nb_stolen_tasks.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+thread_pool::task_group::~task_group() {
+    wait_for_tasks();
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::task_group::submit(task_type task_) {
+    {
+        std::lock_guard lock(mutex);
+        ++nb_pending_tasks;
+    }
+
+    pool.submit([this, task = std::move(task_)]() {
+        if (current_task_stolen) {
+            nb_stolen_tasks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::exception_ptr task_exception;
+        try {
+            task();
+        } catch (...) {
+            task_exception = std::current_exception();
+        }
+
+        std::lock_guard lock(mutex);
+        if (task_exception && !exception) {
+            exception = task_exception;
+        }
+        if (--nb_pending_tasks == 0) {
+            done.notify_all();
+        }
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::task_group::wait() {
+    wait_for_tasks();
+
+    std::lock_guard lock(mutex);
+    if (exception) {
+        std::rethrow_exception(std::exchange(exception, nullptr));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void thread_pool::task_group::wait_for_tasks() {
+    // A thread of the pool runs the queued tasks instead of blocking, the tasks of the group may be behind it
+    if (current_pool == &pool) {
+        while (true) {
+            {
+                std::lock_guard lock(mutex);
+                if (nb_pending_tasks == 0) {
+                    return;
+                }
+            }
+
+            if (!pool.try_run_queued_task(current_queue)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this]() { return nb_pending_tasks == 0; });
+}
@@ -0,0 +1,108 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Fixed-size pool of threads with one task queue per thread. A thread runs the
+// most recent task of its own queue and steals the oldest task of another queue
+// when its own is empty, so uneven tasks are balanced without oversubscription.
+class thread_pool {
+public:
+    using task_type = std::function<void()>;
+
+    explicit thread_pool(size_t nb_threads_ = std::max(std::thread::hardware_concurrency(), 1u));
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Pool shared by the batch operations that are not given one
+    [[nodiscard]] static thread_pool& get_default();
+
+    // Tasks are queued round-robin, or on the queue of the calling thread if it belongs to the pool
+    void submit(task_type task_);
+
+    // Wait until all the tasks submitted so far are done, the first exception thrown by a task is rethrown.
+    // It covers the tasks of every caller and must not be called from a task of the pool, see task_group.
+    void wait();
+
+    [[nodiscard]] size_t get_nb_threads() const { return queues.size(); }
+    [[nodiscard]] size_t get_nb_stolen_tasks() const { return nb_stolen_tasks.load(std::memory_order_relaxed); }
+
+    // Tasks of the pool that are waited for together, independently of the other tasks.
+    // A task of the pool may wait for a group, its thread runs the queued tasks meanwhile.
+    class task_group {
+    public:
+        explicit task_group(thread_pool& pool_)
+            : pool(pool_) {}
+
+        // The tasks still running are waited for, their exceptions are dropped
+        ~task_group();
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        void submit(task_type task_);
+
+        // Wait until the tasks of the group are done, the first exception thrown by one of them is rethrown
+        void wait();
+
+        [[nodiscard]] size_t get_nb_stolen_tasks() const { return nb_stolen_tasks.load(std::memory_order_relaxed); }
+
+    private:
+        void wait_for_tasks();
+
+        thread_pool& pool;
+        std::atomic_size_t nb_stolen_tasks{ 0 };
+
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t nb_pending_tasks = 0;
+        std::exception_ptr exception;
+    };
+
+private:
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<task_type> tasks;
+    };
+
+    void run(std::stop_token stop_, size_t index_);
+
+    // Run one of the queued tasks on the thread of index_, return false if there are none
+    [[nodiscard]] bool try_run_queued_task(size_t index_);
+    void run_reserved_task(size_t index_);
+    [[nodiscard]] bool try_pop(size_t index_, task_type& task_);
+    [[nodiscard]] bool try_steal(size_t index_, task_type& task_);
+
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::atomic_size_t next_queue{ 0 };
+    std::atomic_size_t nb_stolen_tasks{ 0 };
+
+    // Tasks waiting in the queues, the threads sleep while there are none
+    std::mutex wake_mutex;
+    std::condition_variable_any wake;
+    size_t nb_queued_tasks = 0;
+
+    // Tasks submitted and not finished yet
+    std::mutex done_mutex;
+    std::condition_variable done;
+    size_t nb_pending_tasks = 0;
+    std::exception_ptr exception;
+
+    std::vector<std::jthread> threads;
+};
+
+#endif // THREAD_POOL_HPP